@@ -14,5 +14,5 @@ void setup() {
 }
 
 void loop() {
-  app_loop(); // non-blocking loop
+  app_loop(); // jalankan job jatuh tempo, lalu tidur sampai job/event berikutnya
 }
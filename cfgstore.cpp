@@ -0,0 +1,185 @@
+/*
+ * File: cfgstore.cpp
+ * Description: Pending-slot table, CRC trailer and tmp/bak/rename sequence behind the write-behind config store. Generated by AI for clarity.
+ */
+#include "cfgstore.h"
+#include "logview.h"
+#include "crc32.h"
+#include <SD.h>
+
+static constexpr size_t   TRAILER_MAX   = 24;      // "\n#crc32=XXXXXXXX\n"
+static_assert(CFGSTORE_READ_BYTES > CFGSTORE_MAX_BYTES + TRAILER_MAX, "buffer baca < isi + trailer");
+static constexpr uint32_t RETRY_MS      = 5000;    // tulis gagal: coba lagi (SD dicabut, penuh)
+static constexpr size_t   PATH_MAX_LEN  = 40;
+static const char         TRAILER_TAG[] = "\n#crc32=";
+
+struct Slot {
+  char     path[PATH_MAX_LEN];   // "" = kosong
+  bool     dirty;
+  uint32_t t_put_ms;             // perubahan terakhir
+  uint32_t t_retry_ms;           // 0 = boleh tulis; selain itu tunggu sampai waktu ini
+  size_t   n;
+  char     data[CFGSTORE_MAX_BYTES];
+};
+
+static Slot          s_slot[CFGSTORE_SLOTS];
+static bool          s_ready = false;
+static uint32_t      s_quiet_ms = 2000;
+static CfgStoreStats ST{};
+// buffer kerja baca-ulang/verifikasi (hanya di job idle & boot)
+static char          s_io[CFGSTORE_READ_BYTES];
+
+static void side_path(char* out, const char* path, const char* ext){
+  snprintf(out, PATH_MAX_LEN + 4, "%s%s", path, ext);
+}
+
+// ===== Baca & verifikasi satu file =====
+enum Verdict : uint8_t { V_MISSING, V_BAD, V_OK, V_LEGACY };
+
+// Isi (tanpa trailer) ke buf, diakhiri 0
+static Verdict read_file(const char* path, char* buf, size_t cap, size_t& n){
+  n = 0;
+  if (!SD.exists(path)) return V_MISSING;
+  File f = SD.open(path, FILE_READ);
+  if (!f) return V_BAD;
+  size_t sz = f.size();
+  if (sz >= cap){ f.close(); return V_BAD; }
+  size_t got = f.read((uint8_t*)buf, sz);
+  f.close();
+  if (got != sz) return V_BAD;
+  buf[sz] = 0;
+  // trailer terakhir di file; tanpa trailer = file lama / diedit tangan
+  const char* t = nullptr;
+  for (const char* p = buf; (p = strstr(p, TRAILER_TAG)) != nullptr; ++p) t = p;
+  if (!t){ n = sz; return sz ? V_LEGACY : V_BAD; }
+  unsigned long want = strtoul(t + sizeof(TRAILER_TAG) - 1, nullptr, 16);
+  n = (size_t)(t - buf);
+  if (crc32_ieee((const uint8_t*)buf, n) != (uint32_t)want) return V_BAD;
+  buf[n] = 0;
+  return V_OK;
+}
+
+// ===== Tulis atomik =====
+static bool write_all(const char* path, const char* data, size_t n, const char* trailer, size_t tn){
+  File f = SD.open(path, FILE_WRITE);
+  if (!f) return false;
+  bool ok = f.write((const uint8_t*)data, n) == n && f.write((const uint8_t*)trailer, tn) == tn;
+  f.flush();
+  f.close();
+  return ok;
+}
+
+static bool write_atomic(const Slot& s){
+  char tmp[PATH_MAX_LEN + 4], bak[PATH_MAX_LEN + 4];
+  side_path(tmp, s.path, ".tmp");
+  side_path(bak, s.path, ".bak");
+  char trailer[TRAILER_MAX];
+  int tn = snprintf(trailer, sizeof(trailer), "%s%08lx\n", TRAILER_TAG,
+                    (unsigned long)crc32_ieee((const uint8_t*)s.data, s.n));
+
+  // 1. isi baru ke .tmp, baca ulang: hanya salinan terverifikasi yang boleh naik
+  size_t n;
+  if (!write_all(tmp, s.data, s.n, trailer, (size_t)tn)) return false;
+  if (read_file(tmp, s_io, sizeof(s_io), n) != V_OK || n != s.n || memcmp(s_io, s.data, n)) return false;
+
+  // 2. primary lama yang masih valid jadi .bak (bak lama dibuang); yang rusak dibuang saja
+  Verdict v = read_file(s.path, s_io, sizeof(s_io), n);
+  if (v == V_OK || v == V_LEGACY){
+    if (SD.exists(bak) && !SD.remove(bak)) return false;
+    if (!SD.rename(s.path, bak)) return false;
+  } else if (v == V_BAD && !SD.remove(s.path)) return false;
+
+  // 3. .tmp naik jadi primary (FAT: rename tanpa timpa, karena itu primary dipindah dulu)
+  return SD.rename(tmp, s.path);
+}
+
+// ===== API =====
+void cfgstore_begin(uint32_t quiet_ms){
+  s_quiet_ms = quiet_ms;
+  s_ready = true;
+}
+
+bool cfgstore_put(const char* path, const char* data, size_t n){
+  if (n > CFGSTORE_MAX_BYTES || strlen(path) >= PATH_MAX_LEN) return false;
+  Slot* s = nullptr;
+  for (Slot& k : s_slot) if (!strcmp(k.path, path)){ s = &k; break; }
+  if (!s) for (Slot& k : s_slot) if (!k.path[0]){ s = &k; break; }
+  if (!s) return false;
+  strlcpy(s->path, path, sizeof(s->path));
+  memcpy(s->data, data, n);
+  s->n = n;
+  s->dirty = true;
+  s->t_put_ms = millis();
+  s->t_retry_ms = 0;
+  ST.puts++;
+  return true;
+}
+
+bool cfgstore_poll(bool idle){
+  if (!s_ready || !idle) return false;
+  uint32_t now = millis();
+  for (Slot& s : s_slot){
+    if (!s.dirty || now - s.t_put_ms < s_quiet_ms) continue;
+    if (s.t_retry_ms && (int32_t)(now - s.t_retry_ms) < 0) continue;
+    uint32_t t0 = millis();
+    bool ok = write_atomic(s);
+    uint32_t dt = millis() - t0;
+    ST.write_ms_max = max(ST.write_ms_max, dt);
+    if (ok){
+      s.dirty = false;
+      ST.writes++;
+      ST.last_write_ms = millis();
+      logf("[CFG] Saved %s (%u B, %lu ms)", s.path, (unsigned)s.n, (unsigned long)dt);
+    } else {
+      s.t_retry_ms = millis() + RETRY_MS;
+      ST.errors++;
+      logf("[CFG] Save %s FAILED, retry in %lu s", s.path, (unsigned long)(RETRY_MS / 1000));
+    }
+    return true;  // satu file per slice
+  }
+  return false;
+}
+
+CfgSource cfgstore_read(const char* path, char* buf, size_t cap, size_t& n,
+                        bool (*accept)(const char*, size_t)){
+  char side[PATH_MAX_LEN + 4];
+  static const char* const EXT[] = {"", ".tmp", ".bak"};
+  static const CfgSource SRC[] = {CFG_SRC_PRIMARY, CFG_SRC_TMP, CFG_SRC_BACKUP};
+  n = 0;
+  for (uint8_t i = 0; i < 3; ++i){
+    side_path(side, path, EXT[i]);
+    Verdict v = read_file(side, buf, cap, n);
+    if (v == V_MISSING) continue;
+    if (v == V_BAD || (accept && !accept(buf, n))){
+      logf("[CFG] %s corrupt, skipped", side);
+      continue;
+    }
+    ST.last_load = SRC[i];
+    if (i){
+      logf("[CFG] %s restored from %s", path, side);
+      cfgstore_put(path, buf, n);   // primary ditulis ulang saat idle berikutnya
+    }
+    return SRC[i];
+  }
+  n = 0;
+  if (cap) buf[0] = 0;
+  ST.last_load = CFG_SRC_NONE;
+  return CFG_SRC_NONE;
+}
+
+const char* cfgstore_source_str(CfgSource s){
+  switch (s){
+    case CFG_SRC_PRIMARY: return "primary";
+    case CFG_SRC_TMP:     return "tmp";
+    case CFG_SRC_BACKUP:  return "backup";
+    case CFG_SRC_NONE:    break;
+  }
+  return "none";
+}
+
+CfgStoreStats cfgstore_stats(){
+  CfgStoreStats s = ST;
+  s.pending = 0;
+  for (const Slot& k : s_slot) s.pending += k.dirty ? 1 : 0;
+  return s;
+}
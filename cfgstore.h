@@ -0,0 +1,50 @@
+/*
+ * File: cfgstore.h
+ * Description: Write-behind config persistence: RAM-side coalescing, idle-slice SD writes, temp file + rename with CRC and fallback to the previous good copy. Generated by AI for clarity.
+ */
+#pragma once
+/* Persistensi file config kecil (race.json) tanpa menulis SD di handler HTTP:
+   - cfgstore_put() hanya menyalin isi baru ke slot RAM per path (edit beruntun
+     digabung, yang terakhir menang). Config runtime sudah diterapkan pemanggil.
+   - cfgstore_poll(idle) dari job scheduler prioritas terendah: menulis bila isi sudah
+     tenang quiet_ms dan idle=true (race tidak armed/running).
+   - Tulis atomik di FAT: <path>.tmp (isi + trailer "#crc32=XXXXXXXX") -> baca ulang &
+     cek CRC -> primary lama yang valid jadi <path>.bak -> rename .tmp ke <path>.
+   - Baca: <path> -> <path>.tmp -> <path>.bak, salinan pertama yang CRC-nya cocok (atau
+     tanpa trailer: file lama/edit tangan) dan diterima parser pemanggil.
+   Putus daya di langkah mana pun menyisakan setidaknya satu salinan utuh. */
+#include <Arduino.h>
+
+inline constexpr size_t  CFGSTORE_MAX_BYTES = 2048;  // isi config (tanpa trailer)
+inline constexpr uint8_t CFGSTORE_SLOTS     = 2;     // path berbeda yang bisa antri
+inline constexpr size_t  CFGSTORE_READ_BYTES = CFGSTORE_MAX_BYTES + 32;  // buffer cfgstore_read (+ trailer)
+
+enum CfgSource : uint8_t { CFG_SRC_NONE = 0, CFG_SRC_PRIMARY, CFG_SRC_TMP, CFG_SRC_BACKUP };
+
+struct CfgStoreStats {
+  uint8_t  pending;        // slot menunggu ditulis
+  uint32_t puts;           // perubahan diterima (sebelum digabung)
+  uint32_t writes;         // penulisan atomik sukses
+  uint32_t errors;         // tulis/verifikasi/rename gagal (dicoba ulang)
+  uint32_t write_ms_max;   // durasi tulis terlama (di job idle)
+  uint32_t last_write_ms;  // millis() penulisan terakhir
+  CfgSource last_load;     // sumber load terakhir
+};
+
+// Setelah SD siap. quiet_ms: jeda sejak perubahan terakhir sebelum ditulis.
+void cfgstore_begin(uint32_t quiet_ms);
+
+// Antri isi baru untuk path (RAM saja). false bila terlalu besar / slot penuh.
+bool cfgstore_put(const char* path, const char* data, size_t n);
+
+// Dari job idle: tulis satu slot yang jatuh tempo. true bila ada yang ditulis.
+bool cfgstore_poll(bool idle);
+
+// Sinkron (boot): isi salinan valid pertama ke buf (>= CFGSTORE_READ_BYTES, diakhiri 0).
+// accept (opsional) menolak salinan yang CRC-nya cocok tapi isinya tidak bisa di-parse.
+// Salinan dari .tmp/.bak otomatis diantri ulang untuk memulihkan primary.
+CfgSource cfgstore_read(const char* path, char* buf, size_t cap, size_t& n,
+                        bool (*accept)(const char* data, size_t n) = nullptr);
+
+const char* cfgstore_source_str(CfgSource s);
+CfgStoreStats cfgstore_stats();
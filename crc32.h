@@ -0,0 +1,19 @@
+/*
+ * File: crc32.h
+ * Description: Portable bitwise CRC-32 (IEEE) shared by the UDP telemetry packet and the config store. Generated by AI for clarity.
+ */
+#pragma once
+/* CRC-32 IEEE (poly 0xEDB88320, init/xorout 0xFFFFFFFF), hasil sama dengan crc32_le(0, ..)
+   di ROM ESP32. Versi bitwise tanpa tabel untuk blok kecil (paket 116 byte, config
+   ~2 KB) dan agar bisa dibangun di host; blok besar (runlog) tetap pakai ROM. */
+#include <stdint.h>
+#include <stddef.h>
+
+inline uint32_t crc32_ieee(const uint8_t* p, size_t n){
+  uint32_t c = 0xFFFFFFFFu;
+  while (n--){
+    c ^= *p++;
+    for (int k = 0; k < 8; ++k) c = (c >> 1) ^ (0xEDB88320u & (0u - (c & 1u)));
+  }
+  return ~c;
+}
@@ -0,0 +1,105 @@
+/*
+ * File: dlog.cpp
+ * Description: Lock-free record ring for deferred logging and the lazy printf-style formatter that drains it. Generated by AI for clarity.
+ */
+#include "dlog.h"
+#include "logview.h"
+#include <atomic>
+
+static const char* const FMT[DL_COUNT] = {
+  "[RACE] Armed",
+  "[RACE] Disarmed (was running)",
+  "[RACE] START",
+  "[TRAP] %s @%.1fm ET=%.3fs",
+  "[TRAP] %s Trap=%.1f km/h",
+};
+
+struct DlogRec {
+  std::atomic<uint32_t> stamp;  // index+1 setelah record selesai ditulis
+  uint16_t id;
+  uint16_t rsv;
+  uint32_t a[3];
+  char     s[DLOG_STR_MAX + 1];
+};
+static_assert(sizeof(DlogRec) == 48, "DlogRec harus 48 byte");
+
+static constexpr uint32_t RING_RECS = 64;  // pangkat 2; 3 KB
+static DlogRec s_ring[RING_RECS];
+static std::atomic<uint32_t> s_wr{0};      // index record berikutnya (banyak producer)
+static uint32_t s_rd = 0;                  // hanya task UI
+static uint32_t s_dropped = 0;
+
+static void put(uint16_t id, const char* s, uint32_t a0, uint32_t a1, uint32_t a2){
+  uint32_t i = s_wr.fetch_add(1, std::memory_order_relaxed);
+  DlogRec& r = s_ring[i & (RING_RECS - 1)];
+  r.stamp.store(0, std::memory_order_relaxed);   // tandai sedang ditulis
+  std::atomic_thread_fence(std::memory_order_release);
+  r.id = id; r.a[0] = a0; r.a[1] = a1; r.a[2] = a2;
+  if (s){ strncpy(r.s, s, sizeof(r.s) - 1); r.s[sizeof(r.s) - 1] = 0; } else r.s[0] = 0;
+  r.stamp.store(i + 1, std::memory_order_release);
+}
+
+// Format satu record: fmt diproses per konversion, tiap argumen dikonsumsi sesuai tipenya
+static size_t format(const DlogRec& r, char* out, size_t cap){
+  const char* f = (r.id < DL_COUNT) ? FMT[r.id] : "[DLOG] id %u?";
+  uint32_t unk[3] = {r.id, 0, 0};
+  const uint32_t* a = (r.id < DL_COUNT) ? r.a : unk;
+  size_t n = 0; uint8_t ai = 0;
+  while (*f && n + 1 < cap){
+    if (*f != '%'){ out[n++] = *f++; continue; }
+    if (f[1] == '%'){ out[n++] = '%'; f += 2; continue; }
+    char spec[16]; size_t k = 0;
+    do spec[k++] = *f++; while (*f && !strchr("diuxXfeEgGs", *f) && k < sizeof(spec) - 2);
+    char conv = *f ? *f++ : 'u';
+    spec[k++] = conv; spec[k] = 0;
+    int w;
+    if (conv == 's') w = snprintf(out + n, cap - n, spec, r.s);
+    else {
+      uint32_t v = (ai < 3) ? a[ai++] : 0;
+      if (strchr("feEgG", conv)){ float x; memcpy(&x, &v, sizeof(x)); w = snprintf(out + n, cap - n, spec, (double)x); }
+      else if (conv == 'd' || conv == 'i') w = snprintf(out + n, cap - n, spec, (int)(int32_t)v);
+      else w = snprintf(out + n, cap - n, spec, (unsigned)v);
+    }
+    if (w > 0) n = min(n + (size_t)w, cap - 1);
+  }
+  out[n] = 0;
+  return n;
+}
+
+void dlog(uint16_t id, uint32_t a0, uint32_t a1, uint32_t a2){ dlog_s(id, nullptr, a0, a1, a2); }
+
+void dlog_s(uint16_t id, const char* s, uint32_t a0, uint32_t a1, uint32_t a2){
+  if (DLOG_ENABLE){ put(id, s, a0, a1, a2); return; }
+  DlogRec r;
+  r.id = id; r.a[0] = a0; r.a[1] = a1; r.a[2] = a2;
+  strncpy(r.s, s ? s : "", sizeof(r.s) - 1); r.s[sizeof(r.s) - 1] = 0;
+  char line[160];
+  format(r, line, sizeof(line));
+  logln(line);
+}
+
+uint32_t dlog_drain(){
+  uint32_t wr = s_wr.load(std::memory_order_acquire), n = 0;
+  if (wr - s_rd > RING_RECS){                   // producer melewati reader: yang lama hilang
+    uint32_t lost = wr - s_rd - RING_RECS;
+    s_dropped += lost; s_rd += lost;
+    logf("[DLOG] %lu event terbuang", (unsigned long)lost);
+  }
+  char line[160];
+  while (s_rd != wr){
+    const DlogRec& src = s_ring[s_rd & (RING_RECS - 1)];
+    if (src.stamp.load(std::memory_order_acquire) != s_rd + 1) break;  // belum selesai ditulis
+    DlogRec r;
+    r.id = src.id; memcpy(r.a, src.a, sizeof(r.a)); memcpy(r.s, src.s, sizeof(r.s));
+    std::atomic_thread_fence(std::memory_order_acquire);
+    // ditimpa selagi disalin? lewati, dihitung sebagai hilang
+    if (src.stamp.load(std::memory_order_relaxed) != s_rd + 1){ s_dropped++; s_rd++; continue; }
+    s_rd++;
+    format(r, line, sizeof(line));
+    logln(line);
+    n++;
+  }
+  return n;
+}
+
+DlogStats dlog_stats(){ return { s_wr.load(std::memory_order_relaxed), s_dropped }; }
@@ -0,0 +1,43 @@
+/*
+ * File: dlog.h
+ * Description: Deferred binary event log: hot-path sites record a format ID plus raw arguments, text is produced later. Generated by AI for clarity.
+ */
+#pragma once
+/* Log biner ala defmt untuk jalur panas (race_update, crossing trap):
+   - dlog()/dlog_s() hanya menulis record 48 byte (ID format + maks 3 argumen 32-bit +
+     1 string sampai DLOG_STR_MAX karakter) ke ring lock-free: tanpa vsnprintf, String, Serial, atau LVGL.
+   - Teks dibuat belakangan oleh dlog_drain() di konteks UI (idle slice loop(), dan
+     sebelum /log dibaca), lalu masuk logview seperti logln() biasa.
+   - Ring penuh: record tertua ditimpa, drain melaporkan jumlah yang hilang.
+   - DLOG_ENABLE=false: dlog() langsung memformat seperti logf(). */
+#include <Arduino.h>
+#include <string.h>
+
+inline constexpr bool DLOG_ENABLE = true;
+// Panjang string argumen (nama trap) yang tersimpan utuh; lebih panjang dipotong
+inline constexpr size_t DLOG_STR_MAX = 27;
+
+// ID format; teks ada di tabel dlog.cpp (urutan harus sama)
+enum DlogId : uint16_t {
+  DL_RACE_ARMED,
+  DL_RACE_DISARMED_RUN,
+  DL_RACE_START,
+  DL_TRAP_ET,        // s=nama, a0=at_m (f), a1=ET detik (f)
+  DL_TRAP_KPH,       // s=nama, a0=km/h (f)
+  DL_COUNT
+};
+
+// Argumen float disimpan sebagai bit mentah
+inline uint32_t dlog_f(float v){ uint32_t u; memcpy(&u, &v, sizeof(u)); return u; }
+
+void dlog(uint16_t id, uint32_t a0 = 0, uint32_t a1 = 0, uint32_t a2 = 0);
+void dlog_s(uint16_t id, const char* s, uint32_t a0 = 0, uint32_t a1 = 0, uint32_t a2 = 0);
+
+// Format record yang tertunda ke logview; return jumlah record. Hanya dari task UI.
+uint32_t dlog_drain();
+
+struct DlogStats {
+  uint32_t events;    // record ditulis
+  uint32_t dropped;   // record tertimpa sebelum di-drain
+};
+DlogStats dlog_stats();
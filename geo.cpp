@@ -0,0 +1,20 @@
+/*
+ * File: geo.cpp
+ * Description: Builds the local tangent-plane scale factors from WGS84 radii at the origin. Generated by AI for clarity.
+ */
+#include "geo.h"
+#include <math.h>
+
+static constexpr double WGS84_A  = 6378137.0;           // semi-major axis (m)
+static constexpr double WGS84_E2 = 6.69437999014e-3;    // eksentrisitas^2
+
+void geo_frame_begin(GeoFrame& f, int32_t lat0_e7, int32_t lon0_e7){
+  f.lat0_e7 = lat0_e7; f.lon0_e7 = lon0_e7;
+  double phi = lat0_e7 * (1e-7 * M_PI / 180.0);
+  double s = sin(phi);
+  double w = 1.0 - WGS84_E2 * s * s;
+  double N = WGS84_A / sqrt(w);                 // radius prime vertical
+  double M = WGS84_A * (1.0 - WGS84_E2) / (w * sqrt(w)); // radius meridian
+  f.m_per_e7_n = (float)(M * 1e-7 * M_PI / 180.0);
+  f.m_per_e7_e = (float)(N * cos(phi) * 1e-7 * M_PI / 180.0);
+}
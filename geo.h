@@ -0,0 +1,33 @@
+/*
+ * File: geo.h
+ * Description: Local East-North tangent plane anchored at the run start; per-fix distance in float meters. Generated by AI for clarity.
+ */
+#pragma once
+/* Frame ENU lokal (tanpa Up) di titik start.
+   Sekali per run: radius meridian & prime vertical WGS84 di lat0 -> skala m per 1e-7 deg.
+   Per fix: selisih integer 1e-7 deg * skala (float), tanpa sin/cos/atan2 double.
+   Galat proyeksi < 1 mm untuk 400 m (jauh di bawah noise GNSS), dan lebih dekat
+   ke jarak WGS84 sebenarnya dibanding haversine bola R=6371 km (selisih s.d. 0,5%). */
+#include <Arduino.h>
+
+struct GeoFrame {
+  int32_t lat0_e7 = 0, lon0_e7 = 0;  // origin (deg * 1e7)
+  float   m_per_e7_n = 0;            // meter per 1e-7 deg lintang di lat0
+  float   m_per_e7_e = 0;            // meter per 1e-7 deg bujur di lat0 (sudah * cos(lat0))
+};
+
+// Bangun frame di origin (lat0, lon0); satu-satunya tempat trig double dipakai
+void geo_frame_begin(GeoFrame& f, int32_t lat0_e7, int32_t lon0_e7);
+
+// Posisi (deg * 1e7) -> East/North (m) relatif origin. Selisih integer exact;
+// wrap uint32 menghindari overflow bertanda (antimeridian tidak didukung)
+inline void geo_enu(const GeoFrame& f, int32_t lat_e7, int32_t lon_e7, float& e_m, float& n_m){
+  n_m = (float)(int32_t)((uint32_t)lat_e7 - (uint32_t)f.lat0_e7) * f.m_per_e7_n;
+  e_m = (float)(int32_t)((uint32_t)lon_e7 - (uint32_t)f.lon0_e7) * f.m_per_e7_e;
+}
+
+// Jarak horizontal dua titik ENU (m)
+inline float geo_dist_m(float e1, float n1, float e2, float n2){
+  float de = e2 - e1, dn = n2 - n1;
+  return sqrtf(de*de + dn*dn);
+}
@@ -54,7 +54,62 @@ inline constexpr int SD_CS   = 15;
 // ===== GPS (UART) =====
 inline constexpr int GPS_RX   = 27;
 inline constexpr int GPS_TX   = 22;
-inline constexpr uint32_t GPS_BAUD = 115200;
+inline constexpr uint32_t GPS_BAUD = 115200;   // baud awal / fallback bila auto-config gagal
+
+// ===== Auto-config receiver u-blox saat boot (gpscfg.h) =====
+// false: receiver dipakai apa adanya (NMEA @ GPS_BAUD, seperti setup manual)
+inline constexpr bool     GPSCFG_ENABLE     = true;
+inline constexpr uint32_t GPSCFG_BAUD       = 460800; // 20 Hz NAV-PVT ~2 KB/s: sisa lebar untuk burst
+inline constexpr uint16_t GPSCFG_MEAS_MS    = 50;     // 20 Hz, batas M10
+inline constexpr uint8_t  GPSCFG_DYNMODEL   = 4;      // automotive
+inline constexpr uint32_t GPSCFG_TIMEOUT_MS = 15000;  // ~2 putaran scan semua baud
+
+// ===== Pipeline dual-core (opt-in) =====
+// true: GPS + race engine di task sendiri (core 0), UI/HTTP tetap di loop() (core 1)
+inline constexpr bool     PIPELINE_ENABLE = false;
+inline constexpr int      PIPELINE_CORE   = 0;
+inline constexpr int      PIPELINE_PRIO   = 20;   // di atas loopTask (1), di bawah Wi-Fi (23)
+inline constexpr uint32_t PIPELINE_STACK  = 6144; // byte
+
+// ===== Run logger SD (runlog.h) =====
+// Task prioritas rendah menulis blok 4 KB; jalur GPS/race hanya memcpy ke RAM
+inline constexpr bool     RUNLOG_ENABLE = true;
+inline constexpr int      RUNLOG_CORE   = 0;
+inline constexpr int      RUNLOG_PRIO   = 1;    // setara loopTask: tidak pernah mendahului GPS/race
+inline constexpr uint32_t RUNLOG_STACK  = 4096; // byte
+
+// ===== Live telemetry SSE (live.h) =====
+inline constexpr uint16_t LIVE_PORT        = 81;  // http://<ip>:81/live
+inline constexpr uint8_t  LIVE_MAX_CLIENTS = 4;
+inline constexpr uint8_t  LIVE_QUEUE       = 3;   // frame antri per klien; lebih -> buang tertua
+
+// ===== Telemetri UDP biner (udptel.h) =====
+// Satu paket 120 byte per fix ke broadcast subnet (atau grup multicast); decoder: host/udp_recv.cpp
+inline constexpr bool     UDPTEL_ENABLE    = false;
+inline constexpr uint16_t UDPTEL_PORT      = 5005;
+inline constexpr bool     UDPTEL_MULTICAST = false;               // false: broadcast subnet
+inline constexpr uint8_t  UDPTEL_GROUP[4]  = {239, 255, 82, 66};  // dipakai bila MULTICAST
+
+// ===== Scheduler loop (sched.h) =====
+// Periode job; GPS juga dibangunkan langsung oleh burst UART (mode single loop)
+inline constexpr uint32_t SCHED_GPS_MS     = 5;   // cek timeout epoch (40 ms) tanpa burst baru
+inline constexpr uint32_t SCHED_LIVE_MS    = 10;
+inline constexpr uint32_t SCHED_HTTP_MS    = 5;
+inline constexpr uint32_t SCHED_LOG_MS     = 20;
+inline constexpr uint32_t LVGL_MAX_IDLE_MS = 33;  // batas atas jeda lv_timer_handler (touch ~30 Hz)
+inline constexpr uint32_t SCHED_BOOT_MS    = 20;  // tahap boot latar belakang (Wi-Fi, web, config)
+inline constexpr uint32_t WIFI_JOIN_TIMEOUT_MS = 5000;
+inline constexpr uint32_t SCHED_CFG_MS     = 250; // persistensi config (cfgstore.h), prioritas terendah
+
+// ===== Persistensi config write-behind (cfgstore.h) =====
+// Edit config langsung aktif di RAM; SD ditulis setelah tenang & race tidak armed/running
+inline constexpr uint32_t CFG_SAVE_QUIET_MS = 2000;   // edit beruntun dalam jendela ini digabung
+
+// ===== Profiler loop (perf.h) =====
+// 0 = instrumentasi, /api/perf dan layar debug dibuang total saat compile
+#ifndef PERF_ENABLE
+#define PERF_ENABLE 1
+#endif
 
 // ===== Wi-Fi Credentials (ubah sesuai jaringanmu) =====
 inline const char* WIFI_SSID = "YOUR_SSID";
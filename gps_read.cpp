@@ -1,119 +1,311 @@
 /*
  * File: gps_read.cpp
- * Description: Parses NMEA GPS data, applies filtering, and produces validated fixes. Generated by AI for clarity.
+ * Description: Parses NMEA / UBX GPS data, applies filtering, and produces validated fixes. Generated by AI for clarity.
  */
 #include "gps_read.h"
-#include "global.h"
 #include "logview.h"
+#include "timebase.h"
+#include "gps_uart.h"
 #include <math.h>
 #include <algorithm>  // std::swap, std::max
 
-// ====== Serial alias ======
-#define GPS GPSSerial
-
 static GPSFilterTuning T;
 static GPSStats S;
 
-// Ring buffer byte -> line parser
-static String line;            // 1 kalimat NMEA
 // Batas panjang kalimat NMEA; gunakan nama unik agar tidak bentrok dengan macro sistem
 static uint16_t LINE_BUF_MAX = 128;
+static GPSProto PROTO = GPS_PROTO_NMEA;
 
-// Last raw (dari RMC/GGA)
-static bool haveRMC=false, haveGGA=false;
-static double raw_lat=0, raw_lon=0;  // deg
+// Last raw (dari RMC/GGA atau NAV-PVT)
+static int32_t raw_lat=0, raw_lon=0; // deg * 1e7
 static float  raw_sog=0, raw_cog=0;  // m/s, deg
 static float  raw_alt=0, raw_hdop=999;
+static float  raw_hacc=-1, raw_sacc=-1; // m, m/s (hanya UBX)
 static uint8_t raw_sv=0, raw_fixQ=0;
+static uint32_t raw_gnss_ms=0;
+
+// ===== Epoch assembler =====
+// Kalimat dengan waktu GNSS yang sama (UTC ms NMEA / iTOW UBX) digabung jadi
+// satu fix. Fix keluar saat semua kalimat wajib sudah masuk, saat epoch
+// berikutnya mulai, atau setelah timeout.
+static constexpr uint32_t GNSS_MS_NONE = 0xFFFFFFFFu;
+struct EpochState {
+  bool     open;
+  uint32_t key;         // waktu GNSS epoch (ms)
+  uint8_t  have;        // kalimat yang sudah masuk (GPS_SENT_*)
+  uint8_t  ok;          // kalimat yang datanya valid
+  uint32_t t_first_ms;  // millis saat kalimat pertama epoch masuk
+  uint32_t rx_us;       // micros saat kalimat pertama epoch selesai diterima
+  uint32_t last_rx_us;  // micros saat kalimat terakhir epoch selesai diterima
+};
+static EpochState E;
+static uint8_t  EPOCH_NEED = GPS_SENT_GGA | GPS_SENT_RMC;
+static uint16_t EPOCH_TIMEOUT_MS = 40;
+static bool     s_pending = false;   // kalimat lengkap yang belum di-commit
+static uint32_t s_pending_rx_us = 0; // micros saat byte terakhirnya diterima
+
+// Potongan burst dari gps_uart yang sedang di-parse
+static uint8_t  s_rx[128];
+static uint16_t s_rx_n = 0, s_rx_i = 0;
+static uint32_t s_rx_us = 0;         // micros saat burst ini diterima
 
 // Filtered state
 static bool filt_init=false;
 static float sog_prev=0, sog_filt=0;  // m/s
+static float raw_p1=0, raw_p2=0;       // 2 sampel raw sebelumnya (median-of-3)
 static float a_prev=0;                 // m/s^2
+static uint32_t gnss_prev=GNSS_MS_NONE;
 static uint32_t t_prev=0;
 
-static inline uint8_t hex2(byte c){ return (c>='A')?(c-'A'+10):((c>='a')?(c-'a'+10):(c-'0')); }
-
-// deg min.mmmm -> deg
-static double dm_to_deg(double dm){
-  double d = floor(dm/100.0);
-  double m = dm - d*100.0;
-  return d + m/60.0;
-}
-
-static bool nmea_cksum_ok(const char* s){
-  // s: pointer ke char setelah '$', sampai sebelum '*'
-  uint8_t x=0; while (*s && *s!='*'){ x ^= (uint8_t)*s++; }
-  if (*s!='*') return false; s++;
-  if (!s[0]||!s[1]) return false;
-  uint8_t h = (hex2(s[0])<<4) | hex2(s[1]);
-  return x==h;
-}
-
-static bool parse_gga(const String& l){
-  // $GxGGA,time,lat,N,lon,E,fix,sv,hdop,alt,M,....*cs
-  // cepat: pakai strtok manual
-  char buf[160]; size_t n = min(sizeof(buf)-1, (size_t)l.length()); l.toCharArray(buf, n+1);
-  if (!nmea_cksum_ok(buf+1)) { S.cks_fail++; return false; }
-  // tokenizing
-  int fld=0; char* p = buf; char* tok=nullptr;
-  while (*p && *p!='$') p++; if (*p=='$') p++;
-  // ubah '*' jadi ',' biar gampang
-  for (char* q=p; *q; ++q) if (*q=='*') *q=',';
-  double lat_dm=0, lon_dm=0; char latH='N', lonH='E';
-  int fixQ=0, sv=0; float hdop=99, alt=0;
-  while ((tok = strsep(&p, ","))){
-    switch(fld++){
-      case 2: lat_dm = atof(tok); break;
-      case 3: latH   = tok[0];    break;
-      case 4: lon_dm = atof(tok); break;
-      case 5: lonH   = tok[0];    break;
-      case 6: fixQ   = atoi(tok); break;
-      case 7: sv     = atoi(tok); break;
-      case 8: hdop   = atof(tok); break;
-      case 9: alt    = atof(tok); break;
+// ===== Streaming NMEA parser =====
+// Satu pass per byte: XOR checksum, ID kalimat, dan konversi angka dikerjakan
+// saat byte datang. Tidak ada String/heap; hasil di-commit ke raw_* hanya
+// jika checksum cocok.
+enum NmeaState : uint8_t { NS_IDLE, NS_BODY, NS_SKIP, NS_CK1, NS_CK2 };
+enum NmeaMsg   : uint8_t { NM_OTHER, NM_GGA, NM_RMC };
+
+// Akumulator angka desimal untuk field aktif
+struct NmeaNum {
+  uint32_t mant;   // digit tanpa titik
+  uint8_t  frac;   // jumlah digit setelah titik
+  bool     dot, neg, any;
+  char     c0;     // karakter pertama (N/S/E/W/A/V)
+};
+
+struct NmeaParser {
+  NmeaState st;
+  NmeaMsg   msg;
+  uint8_t   x;      // XOR berjalan (antara '$' dan '*')
+  uint8_t   ck;     // checksum dari teks
+  uint8_t   fld;    // index field aktif
+  uint16_t  len;    // panjang kalimat sejauh ini
+  char      id[5];  // field 0 (talker + sentence), mis. "GNRMC"
+  uint8_t   idn;
+  NmeaNum   num;
+  // nilai sementara; di-commit setelah checksum valid
+  uint32_t tod_ms;  // UTC time of day (ms), GNSS_MS_NONE jika kosong
+  int32_t lat_e7, lon_e7;  // magnitudo (deg * 1e7), tanda dari latH/lonH
+  char   latH, lonH, status;
+  uint8_t fixQ, sv;
+  float  hdop, alt, sp_kn, cog;
+};
+static NmeaParser P;
+
+static const float POW10F[] = {1e0f,1e1f,1e2f,1e3f,1e4f,1e5f,1e6f,1e7f,1e8f,1e9f};
+static const uint32_t POW10U[] = {1u,10u,100u,1000u,10000u,100000u,1000000u,10000000u,100000000u,1000000000u};
+
+static inline float  num_f(const NmeaNum& n){ float v = n.mant / POW10F[n.frac]; return n.neg?-v:v; }
+
+// ddmm.mmmm -> deg * 1e7, integer saja (tanpa atof/double).
+// Menit dinormalisasi ke 1e-6 menit (< 6e7, muat uint32); 1e-6 menit = 1e-7 deg / 6.
+static int32_t dm_to_e7(const NmeaNum& n){
+  if (!n.any) return 0;
+  uint32_t div = POW10U[n.frac];
+  uint32_t ip = n.mant / div, fr = n.mant % div;
+  uint32_t mm6 = (ip % 100u) * 1000000u + (n.frac <= 6 ? fr * POW10U[6 - n.frac] : fr / POW10U[n.frac - 6]);
+  return (int32_t)((ip / 100u) * 10000000u + (mm6 + 3u) / 6u);
+}
+
+static inline int8_t hexval(uint8_t c){
+  if (c>='0' && c<='9') return c-'0';
+  if (c>='A' && c<='F') return c-'A'+10;
+  if (c>='a' && c<='f') return c-'a'+10;
+  return -1;
+}
+
+static inline void nmea_num_reset(){ P.num = NmeaNum{0, 0, false, false, false, 0}; }
+
+static void nmea_start(){
+  P.st=NS_BODY; P.msg=NM_OTHER; P.x=0; P.ck=0; P.fld=0; P.len=1; P.idn=0;
+  nmea_num_reset();
+  P.tod_ms=GNSS_MS_NONE; P.lat_e7=0; P.lon_e7=0; P.latH='N'; P.lonH='E'; P.status='V';
+  P.fixQ=0; P.sv=0; P.hdop=99; P.alt=0; P.sp_kn=0; P.cog=0;
+}
+
+// Field selesai (',' atau '*'): simpan ke nilai sementara sesuai jenis kalimat
+static void nmea_field_end(){
+  const NmeaNum& n = P.num;
+  if (P.fld==0){
+    S.nmea_lines++;
+    // $GxGGA / $GxRMC: 2 char talker + 3 char sentence
+    if (P.idn==5 && P.id[2]=='G' && P.id[3]=='G' && P.id[4]=='A') P.msg=NM_GGA;
+    else if (P.idn==5 && P.id[2]=='R' && P.id[3]=='M' && P.id[4]=='C') P.msg=NM_RMC;
+    else P.st=NS_SKIP; // bukan kalimat yang dipakai, abaikan sisa byte
+  } else if (P.fld==1){
+    // hhmmss.sss (GGA & RMC sama-sama field 1)
+    if (n.any){
+      uint32_t div = POW10U[n.frac];
+      uint32_t ip = n.mant / div, fr = n.mant % div;
+      P.tod_ms = ((ip/10000)*3600u + ((ip/100)%100)*60u + ip%100) * 1000u + fr*1000u/div;
+    }
+  } else if (P.msg==NM_GGA){
+    // $GxGGA,time,lat,N,lon,E,fix,sv,hdop,alt,M,....*cs
+    switch(P.fld){
+      case 2: P.lat_e7 = dm_to_e7(n); break;
+      case 3: P.latH   = n.c0;     break;
+      case 4: P.lon_e7 = dm_to_e7(n); break;
+      case 5: P.lonH   = n.c0;     break;
+      case 6: P.fixQ   = (uint8_t)n.mant; break;
+      case 7: P.sv     = (uint8_t)n.mant; break;
+      case 8: P.hdop   = n.any ? num_f(n) : 99.0f; break;
+      case 9: P.alt    = num_f(n); break;
+    }
+  } else if (P.msg==NM_RMC){
+    // $GxRMC,time,status,lat,N,lon,E,speed(kn),cog, date, ... *cs
+    switch(P.fld){
+      case 2: P.status = n.c0;     break; // A=valid
+      case 3: P.lat_e7 = dm_to_e7(n); break;
+      case 4: P.latH   = n.c0;     break;
+      case 5: P.lon_e7 = dm_to_e7(n); break;
+      case 6: P.lonH   = n.c0;     break;
+      case 7: P.sp_kn  = num_f(n); break;
+      case 8: P.cog    = num_f(n); break;
     }
   }
-  if (lat_dm<=0 || lon_dm<=0) return false;
-  double lat = dm_to_deg(lat_dm) * (latH=='S'?-1:1);
-  double lon = dm_to_deg(lon_dm) * (lonH=='W'?-1:1);
-  raw_lat=lat; raw_lon=lon; raw_alt=alt; raw_hdop=hdop; raw_sv=sv; raw_fixQ=fixQ;
-  haveGGA=true; S.gga_ok++; return true;
-}
-
-static bool parse_rmc(const String& l){
-  // $GxRMC,time,status,lat,N,lon,E,speed(kn),cog, date, ... *cs
-  char buf[180]; size_t n = min(sizeof(buf)-1, (size_t)l.length()); l.toCharArray(buf, n+1);
-  if (!nmea_cksum_ok(buf+1)) { S.cks_fail++; return false; }
-  int fld=0; char* p=buf; char* tok=nullptr; for(char* q=p; *q; ++q) if (*q=='*') *q=',';
-  double lat_dm=0, lon_dm=0; char latH='N', lonH='E'; char status='V';
-  float sp_kn=0, cog=0;
-  while ((tok = strsep(&p, ","))){
-    switch(fld++){
-      case 2: status = tok[0]; break; // A=valid
-      case 3: lat_dm = atof(tok); break;
-      case 4: latH   = tok[0];    break;
-      case 5: lon_dm = atof(tok); break;
-      case 6: lonH   = tok[0];    break;
-      case 7: sp_kn  = atof(tok); break;
-      case 8: cog    = atof(tok); break;
+  P.fld++;
+  nmea_num_reset();
+}
+
+// Kualitas GGA selalu di-commit (fixQ=0 harus sampai ke gating); posisi hanya jika ada
+static bool commit_gga(){
+  raw_hdop=P.hdop; raw_sv=P.sv; raw_fixQ=P.fixQ;
+  raw_hacc=-1; raw_sacc=-1;
+  if (P.lat_e7<=0 || P.lon_e7<=0) return false;
+  raw_lat = (P.latH=='S') ? -P.lat_e7 : P.lat_e7;
+  raw_lon = (P.lonH=='W') ? -P.lon_e7 : P.lon_e7;
+  raw_alt=P.alt;
+  S.gga_ok++; return true;
+}
+
+static bool commit_rmc(){
+  if (P.status!='A') return false;
+  if (P.lat_e7<=0 || P.lon_e7<=0) return false;
+  raw_lat = (P.latH=='S') ? -P.lat_e7 : P.lat_e7;
+  raw_lon = (P.lonH=='W') ? -P.lon_e7 : P.lon_e7;
+  raw_cog=P.cog; raw_sog = P.sp_kn * 0.514444f; // kn->m/s
+  S.rmc_ok++; return true;
+}
+
+// Umpan 1 byte; true jika satu kalimat GGA/RMC lengkap dengan checksum cocok
+// (belum di-commit, nilainya tetap di P sampai '$' berikutnya)
+static bool nmea_feed(uint8_t c){
+  if (c=='$'){ nmea_start(); return false; }
+  if (P.st==NS_IDLE) return false;
+  if (++P.len > LINE_BUF_MAX){ P.st=NS_IDLE; return false; } // overflow guard
+
+  switch(P.st){
+    case NS_BODY:
+      if (c=='*'){ nmea_field_end(); P.st=NS_CK1; return false; }
+      if (c=='\r' || c=='\n'){ P.st=NS_IDLE; return false; } // tanpa checksum: buang
+      P.x ^= c;
+      if (c==','){ nmea_field_end(); return false; }
+      if (P.fld==0){ if (P.idn<sizeof(P.id)) P.id[P.idn]=(char)c; P.idn++; return false; }
+      {
+        NmeaNum& n = P.num;
+        if (!n.any && !n.c0) n.c0=(char)c;
+        if (c>='0' && c<='9'){
+          // cukup ~9 digit signifikan; sisa digit pecahan dibuang
+          if (n.mant < 400000000u){ n.mant = n.mant*10u + (c-'0'); if (n.dot) n.frac++; }
+          n.any=true;
+        } else if (c=='.'){ n.dot=true; }
+        else if (c=='-'){ n.neg=true; }
+      }
+      return false;
+
+    case NS_SKIP:
+      if (c=='\r' || c=='\n') P.st=NS_IDLE;
+      return false;
+
+    case NS_CK1: {
+      int8_t h = hexval(c);
+      if (h<0){ S.cks_fail++; P.st=NS_IDLE; return false; }
+      P.ck = (uint8_t)(h<<4); P.st=NS_CK2; return false;
+    }
+
+    case NS_CK2: {
+      int8_t h = hexval(c);
+      P.st=NS_IDLE;
+      if (h<0 || (uint8_t)(P.ck|h)!=P.x){ S.cks_fail++; return false; }
+      return true;
     }
+
+    default: return false;
   }
-  if (status!='A') return false;
-  if (lat_dm<=0 || lon_dm<=0) return false;
-  double lat = dm_to_deg(lat_dm) * (latH=='S'?-1:1);
-  double lon = dm_to_deg(lon_dm) * (lonH=='W'?-1:1);
-  raw_lat=lat; raw_lon=lon; raw_cog=cog; raw_sog = sp_kn * 0.514444f; // kn->m/s
-  haveRMC=true; S.rmc_ok++; return true;
 }
 
-// Haversine (meter)
-static double dist_haversine_m(double lat1,double lon1,double lat2,double lon2){
-  static constexpr double R = 6371000.0;
-  double r1=lat1*M_PI/180.0, r2=lat2*M_PI/180.0, dlat=(lat2-lat1)*M_PI/180.0, dlon=(lon2-lon1)*M_PI/180.0;
-  double a = sin(dlat/2)*sin(dlat/2) + cos(r1)*cos(r2)*sin(dlon/2)*sin(dlon/2);
-  double c = 2*atan2(sqrt(a), sqrt(1-a));
-  return R*c;
+// ===== Streaming UBX parser (NAV-PVT) =====
+// Frame: B5 62 cls id lenL lenH payload[len] ckA ckB (Fletcher-8 atas cls..payload)
+enum UbxState : uint8_t { US_SYNC1, US_SYNC2, US_CLS, US_ID, US_LEN1, US_LEN2, US_PAYLOAD, US_CKA, US_CKB };
+
+static constexpr uint8_t  UBX_CLS_NAV = 0x01;
+static constexpr uint8_t  UBX_ID_PVT  = 0x07;
+static constexpr uint16_t UBX_PVT_LEN = 92;
+static constexpr uint16_t UBX_MAX_LEN = 512;  // lebih panjang = sync palsu / byte panjang rusak
+
+struct UbxParser {
+  UbxState st;
+  uint8_t  cls, id;
+  uint16_t len, pos;
+  uint8_t  ckA, ckB;
+  uint8_t  buf[UBX_PVT_LEN];  // hanya payload NAV-PVT yang disimpan
+};
+static UbxParser U;
+
+static inline uint16_t rd_u2(const uint8_t* p){ return (uint16_t)(p[0] | (p[1]<<8)); }
+static inline uint32_t rd_u4(const uint8_t* p){ return (uint32_t)p[0] | ((uint32_t)p[1]<<8) | ((uint32_t)p[2]<<16) | ((uint32_t)p[3]<<24); }
+static inline int32_t  rd_i4(const uint8_t* p){ return (int32_t)rd_u4(p); }
+
+static inline void ubx_ck(uint8_t b){ U.ckA += b; U.ckB += U.ckA; }
+
+// Kualitas & posisi PVT selalu di-commit; fixQ=0 bila belum 3D
+static bool commit_pvt(){
+  const uint8_t* q = U.buf;
+  // offset sesuai u-blox M10 interface description, UBX-NAV-PVT
+  uint8_t fixType = q[20];
+  uint8_t flags   = q[21];
+  bool fixOK = (flags & 0x01) && fixType>=3 && fixType<=4; // 3D / GNSS+DR
+  raw_gnss_ms = rd_u4(q+0);               // iTOW
+  raw_sv   = q[23];
+  raw_lon  = rd_i4(q+24);                 // 1e-7 deg, format sama dengan raw_*
+  raw_lat  = rd_i4(q+28);
+  raw_alt  = rd_i4(q+36) * 0.001f;        // hMSL mm
+  raw_hacc = rd_u4(q+40) * 0.001f;        // mm
+  raw_sog  = rd_u4(q+60) * 0.001f;        // gSpeed mm/s
+  raw_cog  = rd_i4(q+64) * 1e-5f;         // headMot 1e-5 deg
+  raw_sacc = rd_u4(q+68) * 0.001f;        // mm/s
+  raw_hdop = rd_u2(q+76) * 0.01f;         // pDOP
+  raw_fixQ = fixOK ? ((flags & 0x02) ? 2 : 1) : 0; // diffSoln -> setara DGPS
+  S.ubx_pvt_ok++; return true;
+}
+
+// Umpan 1 byte; true jika satu NAV-PVT lengkap dengan checksum cocok (belum di-commit)
+static bool ubx_feed(uint8_t b){
+  switch(U.st){
+    case US_SYNC1: if (b==0xB5) U.st=US_SYNC2; return false;
+    case US_SYNC2: U.st = (b==0x62) ? US_CLS : (b==0xB5 ? US_SYNC2 : US_SYNC1); return false;
+    case US_CLS:   U.cls=b; U.ckA=0; U.ckB=0; ubx_ck(b); U.st=US_ID; return false;
+    case US_ID:    U.id=b;  ubx_ck(b); U.st=US_LEN1; return false;
+    case US_LEN1:  U.len=b; ubx_ck(b); U.st=US_LEN2; return false;
+    case US_LEN2:
+      U.len |= (uint16_t)b<<8; ubx_ck(b); U.pos=0;
+      // jangan telan sampai 64 KB sebagai payload (berdetik-detik fix hilang): sinkron ulang
+      if (U.len > UBX_MAX_LEN){ S.ubx_bad_len++; U.st=US_SYNC1; return false; }
+      U.st = U.len ? US_PAYLOAD : US_CKA;
+      return false;
+    case US_PAYLOAD:
+      if (U.pos < UBX_PVT_LEN) U.buf[U.pos]=b;
+      U.pos++; ubx_ck(b);
+      if (U.pos >= U.len) U.st=US_CKA;
+      return false;
+    case US_CKA:
+      if (b!=U.ckA){ S.ubx_cks_fail++; U.st=US_SYNC1; return false; }
+      U.st=US_CKB; return false;
+    case US_CKB:
+      U.st=US_SYNC1;
+      if (b!=U.ckB){ S.ubx_cks_fail++; return false; }
+      return (U.cls==UBX_CLS_NAV && U.id==UBX_ID_PVT && U.len==UBX_PVT_LEN);
+  }
+  return false;
 }
 
 // median of 3
@@ -125,64 +317,75 @@ static inline float med3(float a, float b, float c){
   return b;
 }
 
-void gps_reader_begin(uint16_t lineBuf){
+// Waktu GNSS dari kalimat/frame yang menunggu commit
+static uint32_t pending_key(){
+  return (PROTO==GPS_PROTO_UBX) ? rd_u4(U.buf) : P.tod_ms;
+}
+
+// Commit kalimat/frame ke raw_*; return bit GPS_SENT_* nya
+static uint8_t commit_pending(bool& ok){
+  if (PROTO==GPS_PROTO_UBX){ ok = commit_pvt(); return GPS_SENT_PVT; }
+  if (P.msg==NM_GGA){ ok = commit_gga(); return GPS_SENT_GGA; }
+  ok = commit_rmc(); return GPS_SENT_RMC;
+}
+
+// t_us: epoch pengukuran di domain micros() (dari timebase)
+static GPSFix make_fix(uint32_t t_us, bool valid){
+  GPSFix f;
+  f.lat_e7 = raw_lat; f.lon_e7 = raw_lon; f.alt_m = raw_alt;
+  f.sog_mps = sog_filt; f.cog_deg = raw_cog;
+  f.hdop = raw_hdop; f.hacc_m = raw_hacc; f.sacc_mps = raw_sacc;
+  f.fixQ = raw_fixQ; f.sv = raw_sv;
+  f.gnss_ms = raw_gnss_ms; f.t_us = t_us;
+  f.rx_us = E.last_rx_us;   // epoch yang baru ditutup
+  f.t_ms = millis() - (uint32_t)((int32_t)(micros() - t_us) / 1000);
+  f.valid = valid;
+  return f;
+}
+
+void gps_reader_begin(uint16_t lineBuf, GPSProto proto){
   // Pastikan buffer tidak kurang dari 96 karakter
   LINE_BUF_MAX = std::max<uint16_t>(lineBuf, static_cast<uint16_t>(96));
-  line.reserve(LINE_BUF_MAX);
-  haveGGA=haveRMC=false;
+  PROTO = proto;
+  P = NmeaParser{};
+  U = UbxParser{};
+  E = EpochState{};
+  EPOCH_NEED = (proto==GPS_PROTO_UBX) ? GPS_SENT_PVT : (GPS_SENT_GGA | GPS_SENT_RMC);
+  s_pending = false;
+  s_rx_n = s_rx_i = 0;
+  timebase_reset(proto==GPS_PROTO_UBX ? 604800000u : 86400000u);
   filt_init=false;
+  gnss_prev = GNSS_MS_NONE;
   S = GPSStats{};
 }
 
 void gps_set_filter_tuning(const GPSFilterTuning& t){ T = t; }
 
-const GPSStats& gps_stats(){ return S; }
-
-bool gps_poll(GPSFix& out){
-  // Baca per loop semua byte yang ada, pecah per-line
-  bool any=false;
-  while (GPSSerial.available()){
-    int c = GPSSerial.read();
-    if (c<0) break;
-    char ch = (char)c;
-    if (ch=='\r') continue;
-    if (ch=='\n'){
-      if (line.length()>5 && line[0]=='$'){
-        S.nmea_lines++;
-        if (line.indexOf("GGA")>=0) parse_gga(line);
-        else if (line.indexOf("RMC")>=0) parse_rmc(line);
-        // Reset jika terlalu panjang
-        if (line.length()>LINE_BUF_MAX) line.remove(0);
-      }
-      line = "";
-    } else {
-      if (line.length() < LINE_BUF_MAX) line += ch;
-      else line = ""; // overflow guard
-    }
-    any=true;
-  }
-  if (!any) return false;
-
-  // Bila punya RMC atau GGA terbaru → buat fix gabungan
-  if (!(haveGGA || haveRMC)) return false;
-
-  uint32_t tnow = millis();
+void gps_set_epoch(uint8_t need_mask, uint16_t timeout_ms){
+  if (need_mask) EPOCH_NEED = need_mask;
+  EPOCH_TIMEOUT_MS = timeout_ms;
+}
 
-  // ===== Gating kualitas =====
-  bool quality_ok = (raw_fixQ>0) && (raw_hdop<=T.max_hdop_m);
-  if (!quality_ok){
-    S.reject_hdop++;
-    out = {raw_lat, raw_lon, raw_alt, sog_filt, raw_cog, raw_hdop, raw_fixQ, raw_sv, tnow, false};
-    return true; // laporkan juga sbg "invalid" untuk UI
-  }
+const GPSStats& gps_stats(){
+  const GPSUartStats& u = gps_uart_stats();
+  S.uart_fifo_ovf = u.fifo_ovf; S.uart_buf_full = u.buf_full; S.uart_drop = u.ring_drop;
+  return S;
+}
 
-  // ===== Filter kecepatan =====
-  float dt = (tnow - t_prev) * 0.001f;
-  dt = dt > 0 ? dt : 0.05f;
+// Selisih waktu GNSS (ms) dengan wrap tengah malam (UTC) / akhir minggu (iTOW)
+static uint32_t gnss_delta_ms(uint32_t a, uint32_t b){
+  if (b >= a) return b - a;
+  uint32_t period = (PROTO==GPS_PROTO_UBX) ? 604800000u : 86400000u;
+  return b + period - a;
+}
 
-  // median-of-3 (raw trio: prev_raw ~ sog_prev, raw_sog, pred)
-  float pred = sog_prev; // prediksi sederhana
-  float sog_med = med3(sog_prev, raw_sog, pred);
+// Filter kecepatan: median-of-3 + EMA adaptif terhadap jerk. Update sog_filt.
+static void filter_speed(float raw, float dt){
+  // median-of-3 atas 3 sampel raw terakhir (trio lama sog_prev,raw,sog_prev
+  // selalu menghasilkan sog_prev sehingga filter tidak pernah bergerak)
+  if (!filt_init){ raw_p1 = raw_p2 = raw; }
+  float sog_med = med3(raw_p2, raw_p1, raw);
+  raw_p2 = raw_p1; raw_p1 = raw;
 
   // accel & jerk
   float a = (sog_med - sog_prev) / max(dt, 1e-3f);
@@ -193,7 +396,7 @@ bool gps_poll(GPSFix& out){
   float alpha = T.ema_alpha_max - (T.ema_alpha_max-T.ema_alpha_min) * (j / (j + T.max_jerk_mps3));
   alpha = constrain(alpha, T.ema_alpha_min, T.ema_alpha_max);
 
-  if (!filt_init){ sog_filt = raw_sog; filt_init=true; }
+  if (!filt_init){ sog_filt = raw; filt_init=true; }
   else           { sog_filt = sog_filt + alpha * (sog_med - sog_filt); }
 
   // outlier clamp terhadap lonjakan tak wajar
@@ -206,8 +409,83 @@ bool gps_poll(GPSFix& out){
   // Update memory
   sog_prev = sog_filt;
   a_prev   = a;
+}
+
+bool gps_poll(GPSFix& out){
+  // Parse per byte; berhenti begitu satu epoch siap dikeluarkan.
+  // Kalimat milik epoch berikutnya ditahan (s_pending) sampai panggilan berikut.
+  bool ready=false;
+  for (;;){
+    if (s_pending){
+      uint32_t key = pending_key();
+      if (E.open && key!=E.key){ ready=true; break; } // epoch lama tutup dulu
+      s_pending=false;
+      bool ok=false;
+      uint8_t bit = commit_pending(ok);
+      if (!E.open){ E = EpochState{true, key, 0, 0, millis(), s_pending_rx_us, s_pending_rx_us}; }
+      E.last_rx_us = s_pending_rx_us;
+      E.have |= bit;
+      if (ok) E.ok |= bit;
+      if ((E.have & EPOCH_NEED)==EPOCH_NEED){ ready=true; break; }
+      continue;
+    }
+    if (s_rx_i >= s_rx_n){
+      s_rx_i = 0;
+      s_rx_n = (uint16_t)gps_uart_read(s_rx, sizeof(s_rx), s_rx_us);
+      if (!s_rx_n) break;
+    }
+    uint8_t c = s_rx[s_rx_i++];
+    s_pending = (PROTO==GPS_PROTO_UBX) ? ubx_feed(c) : nmea_feed(c);
+    if (s_pending) s_pending_rx_us = s_rx_us;
+  }
+  if (!ready && E.open && (millis() - E.t_first_ms) >= EPOCH_TIMEOUT_MS) ready=true;
+  if (!ready) return false;
+
+  // ===== Tutup epoch =====
+  const uint8_t have = E.have, ok = E.ok;
+  const uint32_t key = E.key;
+  E.open = false;
+  S.epochs++;
+  if ((have & EPOCH_NEED)!=EPOCH_NEED) S.epoch_partial++;
+  raw_gnss_ms = key;
+
+  // Stempel waktu = epoch pengukuran GNSS, bukan saat UART kebetulan dibaca
+  uint32_t t_us = E.rx_us;
+  if (key!=GNSS_MS_NONE){
+    timebase_observe(key, E.rx_us);
+    timebase_to_us(key, E.rx_us, t_us);
+  }
+  uint32_t tnow = millis();
+
+  // Kecepatan wajib berasal dari epoch ini (RMC/PVT); GGA yang hilang pakai kualitas terakhir
+  if (!(ok & (GPS_SENT_RMC | GPS_SENT_PVT))){
+    out = make_fix(t_us, false);
+    return true;
+  }
+
+  // ===== Gating kualitas =====
+  // UBX punya estimasi akurasi asli; NMEA hanya HDOP
+  bool acc_ok = (raw_hacc>=0) ? (raw_hacc<=T.max_hacc_m && raw_sacc<=T.max_sacc_mps)
+                              : (raw_hdop<=T.max_hdop_m);
+  bool quality_ok = (raw_fixQ>0) && acc_ok;
+  if (!quality_ok){
+    if (raw_hacc>=0) S.reject_acc++; else S.reject_hdop++;
+    out = make_fix(t_us, false);
+    return true; // laporkan juga sbg "invalid" untuk UI
+  }
+
+  // ===== Filter kecepatan =====
+  // dt dari waktu GNSS (tepat per epoch); fallback ke millis bila waktu kosong
+  float dt;
+  if (key!=GNSS_MS_NONE && gnss_prev!=GNSS_MS_NONE) dt = gnss_delta_ms(gnss_prev, key) * 0.001f;
+  else                                               dt = (tnow - t_prev) * 0.001f;
+  dt = (dt > 0 && dt < 5.0f) ? dt : 0.05f;
+
+  filter_speed(raw_sog, dt);
+
+  gnss_prev= key;
   t_prev   = tnow;
 
-  out = {raw_lat, raw_lon, raw_alt, sog_filt, raw_cog, raw_hdop, raw_fixQ, raw_sv, tnow, true};
+  out = make_fix(t_us, true);
   return true;
 }
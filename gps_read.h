@@ -7,35 +7,68 @@
 
 // ===== Fix terfilter =====
 struct GPSFix {
-  double lat;       // deg
-  double lon;       // deg
-  double alt_m;     // meters
+  int32_t lat_e7;   // deg * 1e7 (format UBX; NMEA dikonversi integer)
+  int32_t lon_e7;   // deg * 1e7
+  float  alt_m;     // meters
   float  sog_mps;   // speed over ground (filtered), m/s
   float  cog_deg;   // course over ground, deg 0..360
-  float  hdop;      // meters-ish (from GGA)
+  float  hdop;      // meters-ish (from GGA; UBX: pDOP)
+  float  hacc_m;    // horizontal accuracy estimate (UBX hAcc), <0 = tidak ada (NMEA)
+  float  sacc_mps;  // speed accuracy estimate (UBX sAcc), <0 = tidak ada (NMEA)
   uint8_t fixQ;     // GGA fix quality (0=no fix,1=GPS,2=DGPS,...)
   uint8_t sv;       // satellites
-  uint32_t t_ms;    // monotonic ms (millis) of this fix
+  uint32_t gnss_ms; // GNSS time of epoch, ms (NMEA: UTC time of day, UBX: iTOW)
+  uint32_t t_us;    // measurement epoch di domain micros() (timebase GNSS)
+  uint32_t t_ms;    // monotonic ms (millis) of this fix (= t_us dalam ms)
+  uint32_t rx_us;   // micros saat byte terakhir epoch ini diterima (ukur latency pipeline)
   bool valid;       // passed gating/filter
 };
 
+// Derajat (double) hanya untuk tepi API yang butuh (UI, export)
+inline double gps_e7_to_deg(int32_t v){ return v * 1e-7; }
+
 // Statistik ringan
 struct GPSStats {
   uint32_t nmea_lines = 0;
   uint32_t gga_ok = 0;
   uint32_t rmc_ok = 0;
   uint32_t cks_fail = 0;
+  uint32_t ubx_pvt_ok = 0;
+  uint32_t ubx_cks_fail = 0;
+  uint32_t ubx_bad_len = 0;  // header UBX dengan panjang tidak wajar (sinkron ulang)
   uint32_t reject_hdop = 0;
+  uint32_t reject_acc = 0;   // ditolak karena hAcc/sAcc (UBX)
   uint32_t reject_jump = 0;
+  uint32_t epochs = 0;         // fix yang dikeluarkan (1 per epoch GNSS)
+  uint32_t epoch_partial = 0;  // epoch ditutup sebelum semua kalimat wajib masuk
+  uint32_t uart_fifo_ovf = 0;  // FIFO UART overflow (byte hilang di hardware)
+  uint32_t uart_buf_full = 0;  // buffer RX driver penuh
+  uint32_t uart_drop = 0;      // byte dibuang karena ring ingest penuh
+};
+
+// Format input dari receiver
+enum GPSProto : uint8_t {
+  GPS_PROTO_NMEA = 0,  // teks GGA + RMC
+  GPS_PROTO_UBX  = 1   // biner UBX-NAV-PVT (92 byte per epoch)
 };
 
-void gps_reader_begin(uint16_t lineBuf = 128); // siapkan parser
-bool gps_poll(GPSFix& out);                    // panggil sering; true jika ada fix baru
+// Kalimat yang membentuk satu epoch
+enum : uint8_t {
+  GPS_SENT_GGA = 1 << 0,
+  GPS_SENT_RMC = 1 << 1,
+  GPS_SENT_PVT = 1 << 2
+};
+
+void gps_reader_begin(uint16_t lineBuf = 128,
+                      GPSProto proto = GPS_PROTO_NMEA); // siapkan parser
+bool gps_poll(GPSFix& out);                    // panggil sering; true 1x per epoch GNSS
 const GPSStats& gps_stats();                   // baca statistik
 
 // Tuning filter (opsional, bisa dibiarkan default)
 struct GPSFilterTuning {
   float max_hdop_m = 1.5f;     // tolak fix jika > ini
+  float max_hacc_m = 2.5f;     // UBX: tolak fix jika hAcc > ini
+  float max_sacc_mps = 1.0f;   // UBX: tolak fix jika sAcc > ini
   float max_accel_mps2 = 8.0f; // clamp percepatan (drag start tinggi; adjust bila perlu)
   float max_jerk_mps3  = 40.0f;// deteksi outlier
   float ema_alpha_min  = 0.12f;// smoothing max
@@ -43,3 +76,7 @@ struct GPSFilterTuning {
 };
 
 void gps_set_filter_tuning(const GPSFilterTuning& t);
+
+// Epoch assembler: kalimat wajib per epoch (GPS_SENT_*) & batas tunggu sejak kalimat
+// pertama. Default NMEA: GGA|RMC, UBX: PVT; 40 ms.
+void gps_set_epoch(uint8_t need_mask, uint16_t timeout_ms = 40);
@@ -0,0 +1,81 @@
+/*
+ * File: gps_uart.cpp
+ * Description: UART RX event callback that moves GPS bytes into an SPSC ring in bursts. Generated by AI for clarity.
+ */
+#include "gps_uart.h"
+#include "global.h"
+#include "spsc_ring.h"
+
+static constexpr size_t   GPS_UART_RX_BUF = 1024;  // buffer driver (sebelum begin)
+static constexpr uint8_t  GPS_UART_RX_TO  = 4;     // RX timeout (simbol) = jeda antar kalimat
+
+// Penanda burst: posisi akhir byte di ring + waktu terima
+struct BurstMark { uint32_t end; uint32_t rx_us; };
+
+static SpscBytes<4096>         s_ring;
+static SpscRing<BurstMark, 32> s_marks;   // penuh -> burst digabung ke penanda berikutnya
+static BurstMark               s_cur{0, 0}; // burst yang sedang dibaca konsumen
+static GPSUartStats            ST;
+static volatile TaskHandle_t   s_waiter = nullptr;
+static uint32_t                s_baud = 0;
+
+// Jalan di task event UART (producer tunggal)
+static void on_rx(){
+  uint32_t now = micros();
+  uint8_t tmp[128];
+  size_t n;
+  while ((n = GPSSerial.read(tmp, std::min<size_t>(sizeof(tmp), GPSSerial.available()))) > 0){
+    size_t w = s_ring.write(tmp, n);
+    ST.bytes += w;
+    ST.ring_drop += n - w;
+  }
+  ST.bursts++;
+  s_marks.push({s_ring.head(), now});
+  TaskHandle_t t = s_waiter;
+  if (t) xTaskNotifyGive(t);
+}
+
+static void on_rx_error(hardwareSerial_error_t err){
+  if (err == UART_FIFO_OVF_ERROR) ST.fifo_ovf++;
+  else if (err == UART_BUFFER_FULL_ERROR) ST.buf_full++;
+}
+
+bool gps_uart_begin(uint32_t baud, int rx_pin, int tx_pin){
+  GPSSerial.setRxBufferSize(GPS_UART_RX_BUF);
+  GPSSerial.begin(baud, SERIAL_8N1, rx_pin, tx_pin);
+  GPSSerial.setRxTimeout(GPS_UART_RX_TO);
+  // onlyOnTimeout=false: event FIFO penuh juga memicu baca, jadi burst panjang
+  // (UBX + NMEA sekaligus) tidak menumpuk di buffer driver
+  GPSSerial.onReceive(on_rx, false);
+  GPSSerial.onReceiveError(on_rx_error);
+  s_baud = baud;
+  return true;
+}
+
+size_t gps_uart_write(const uint8_t* src, size_t n){ return GPSSerial.write(src, n); }
+
+void gps_uart_set_baud(uint32_t baud){
+  GPSSerial.updateBaudRate(baud);
+  s_baud = baud;
+}
+
+uint32_t gps_uart_baud(){ return s_baud; }
+
+size_t gps_uart_read(uint8_t* dst, size_t n, uint32_t& rx_us){
+  // byte di ring tanpa penanda belum dianggap terima; tunggu callback selesai
+  while (s_ring.tail() == s_cur.end){ if (!s_marks.pop(s_cur)) return 0; }
+  rx_us = s_cur.rx_us;
+  return s_ring.read(dst, n, s_cur.end);
+}
+
+size_t gps_uart_available(){ return s_ring.size(); }
+
+bool gps_uart_wait(uint32_t timeout_ms){
+  s_waiter = xTaskGetCurrentTaskHandle(); // daftar dulu agar notify tidak terlewat
+  if (s_ring.tail() != s_cur.end || !s_marks.empty()){ s_waiter = nullptr; return true; }
+  bool got = ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(timeout_ms)) > 0;
+  s_waiter = nullptr;
+  return got;
+}
+
+const GPSUartStats& gps_uart_stats(){ return ST; }
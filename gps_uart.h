@@ -0,0 +1,40 @@
+/*
+ * File: gps_uart.h
+ * Description: Event-driven GPS UART ingest: bulk reads into a preallocated ring with loss counters. Generated by AI for clarity.
+ */
+#pragma once
+/* Ingest UART GPS berbasis event driver (RX timeout / FIFO full) lewat
+   HardwareSerial::onReceive. Callback jalan di task event UART, membaca bulk
+   ke ring SPSC; gps_poll() mengambil per burst beserta micros() penerimaannya.
+   Overflow FIFO / buffer driver / ring dihitung, tidak lagi hilang diam-diam. */
+#include <Arduino.h>
+
+struct GPSUartStats {
+  uint32_t bursts = 0;     // callback RX (akhir burst / FIFO penuh)
+  uint32_t bytes = 0;      // byte masuk ring
+  uint32_t fifo_ovf = 0;   // FIFO hardware overflow (UART_FIFO_OVF_ERROR)
+  uint32_t buf_full = 0;   // buffer RX driver penuh (UART_BUFFER_FULL_ERROR)
+  uint32_t ring_drop = 0;  // byte dibuang karena ring penuh (konsumen terlambat)
+};
+
+// Buka GPSSerial & pasang callback event. Ganti GPSSerial.begin().
+bool gps_uart_begin(uint32_t baud, int rx_pin, int tx_pin);
+
+// Ambil byte dari satu burst (maks n). rx_us = micros() saat burst diterima.
+// 0 jika tidak ada data.
+size_t gps_uart_read(uint8_t* dst, size_t n, uint32_t& rx_us);
+
+size_t gps_uart_available();
+
+// Kirim ke receiver (perintah konfigurasi UBX/PUBX). Pesan pendek (< FIFO TX) tidak
+// menunggu; ganti baud baru aman setelah byte terakhir keluar (beri jeda).
+size_t gps_uart_write(const uint8_t* src, size_t n);
+
+// Ganti baud UART tanpa buka ulang driver/callback
+void gps_uart_set_baud(uint32_t baud);
+uint32_t gps_uart_baud();
+
+// Blok sampai ada burst baru atau timeout (untuk task konsumen)
+bool gps_uart_wait(uint32_t timeout_ms);
+
+const GPSUartStats& gps_uart_stats();
@@ -0,0 +1,315 @@
+/*
+ * File: gpscfg.cpp
+ * Description: u-blox auto-configuration state machine: UART sniffer for NMEA/UBX/ACK, CFG-VALSET builder and timed state transitions. Generated by AI for clarity.
+ */
+#include "gpscfg.h"
+#include "gps_uart.h"
+#include "logview.h"
+
+// Kandidat deteksi baud. Indeks 0 = baud target: receiver yang sudah dikonfigurasi
+// boot sebelumnya (ESP32 reset tanpa power cycle GPS) langsung ketemu.
+static const uint32_t SCAN_BAUDS[] = {0, 9600, 115200, 38400, 57600, 230400};
+static constexpr uint8_t  N_SCAN     = sizeof(SCAN_BAUDS) / sizeof(SCAN_BAUDS[0]);
+static constexpr uint32_t PROBE_MS   = 1100;  // > 1 epoch pada rate pabrik 1 Hz
+static constexpr uint32_t SETTLE_MS  = 100;   // byte TX keluar + receiver pindah baud
+static constexpr uint32_t ACK_MS     = 500;
+static constexpr uint8_t  MAX_RETRY  = 3;
+static constexpr uint32_t VERIFY_MS  = 1500;
+static constexpr uint8_t  VERIFY_PVT = 8;     // frame NAV-PVT untuk ukur periode
+static constexpr uint8_t  NMEA_MAX   = 96;    // kalimat lebih panjang = sampah baud salah
+
+// ===== UBX =====
+static constexpr uint8_t UBX_CLS_NAV = 0x01, UBX_NAV_PVT    = 0x07;
+static constexpr uint8_t UBX_CLS_ACK = 0x05, UBX_ACK_ACK    = 0x01, UBX_ACK_NAK = 0x00;
+static constexpr uint8_t UBX_CLS_CFG = 0x06, UBX_CFG_VALSET = 0x8A;
+
+// Key CFG (u-blox M10 SPG 5.x); ukuran nilai ada di bit 28..30 key
+static constexpr uint32_t K_UART1_BAUDRATE  = 0x40520001u; // U4
+static constexpr uint32_t K_RATE_MEAS       = 0x30210001u; // U2 ms
+static constexpr uint32_t K_RATE_NAV        = 0x30210002u; // U2 siklus per solusi
+static constexpr uint32_t K_NAVSPG_DYNMODEL = 0x20110021u; // E1
+static constexpr uint32_t K_UART1OUT_UBX    = 0x10740001u; // L
+static constexpr uint32_t K_UART1OUT_NMEA   = 0x10740002u; // L
+static constexpr uint32_t K_MSG_PVT_UART1   = 0x20910007u; // U1 (1 = tiap solusi)
+
+enum GcState : uint8_t { GC_PROBE, GC_BAUD_SETTLE, GC_BAUD_CHECK, GC_APPLY_ACK, GC_VERIFY, GC_DONE };
+static const char* const STATE_STR[] = {"probe", "baud", "baud_check", "apply", "verify", "done"};
+
+// ===== Sniffer RX: hanya hitung trafik valid & tangkap ACK, tidak menyimpan payload =====
+struct Sniff {
+  uint8_t  ust;               // 0..8 seperti parser UBX gps_read
+  uint8_t  cls, id, ckA, ckB, p0, p1;
+  uint16_t len, pos;
+  bool     nm_on, nm_star;    // di dalam kalimat NMEA / setelah '*'
+  uint8_t  nm_x, nm_n, nm_hex, nm_ck;
+};
+
+static GpsCfgTarget T;
+static Sniff        N{};
+static GcState      s_st = GC_DONE;
+static GpsCfgResult s_res = GCR_NO_RX;
+static GPSProto     s_proto = GPS_PROTO_NMEA;
+static uint8_t      s_scan = 0;
+static uint32_t     s_base_baud = 0, s_found = 0;
+static uint32_t     s_t0 = 0, s_t_state = 0, s_dur = 0;
+static bool         s_pubx_tried = false;
+static uint8_t      s_acks = 0, s_naks = 0, s_retries = 0;
+static uint16_t     s_pvt_ms = 0;
+// sejak masuk state terakhir
+static uint32_t     s_nmea = 0, s_frames = 0, s_pvt = 0;
+static uint8_t      s_ack = 0;                 // 0 tunggu, 1 ACK, 2 NAK (untuk CFG-VALSET)
+static uint32_t     s_pvt_first_us = 0, s_pvt_last_us = 0;
+static bool         s_last_pvt = false;        // jenis trafik valid terakhir
+
+static void on_ubx(uint32_t rx_us){
+  s_frames++;
+  if (N.cls == UBX_CLS_ACK && N.len == 2 && N.p0 == UBX_CLS_CFG && N.p1 == UBX_CFG_VALSET)
+    s_ack = (N.id == UBX_ACK_ACK) ? 1 : (N.id == UBX_ACK_NAK ? 2 : s_ack);
+  if (N.cls == UBX_CLS_NAV && N.id == UBX_NAV_PVT){
+    if (!s_pvt) s_pvt_first_us = rx_us;
+    s_pvt_last_us = rx_us;
+    s_pvt++;
+    s_last_pvt = true;
+  }
+}
+
+static inline void ck(uint8_t b){ N.ckA += b; N.ckB += N.ckA; }
+
+static void sniff_ubx(uint8_t b, uint32_t rx_us){
+  switch (N.ust){
+    case 0: if (b == 0xB5) N.ust = 1; return;
+    case 1: N.ust = (b == 0x62) ? 2 : (b == 0xB5 ? 1 : 0); return;
+    case 2: N.cls = b; N.ckA = N.ckB = 0; ck(b); N.ust = 3; return;
+    case 3: N.id = b; ck(b); N.ust = 4; return;
+    case 4: N.len = b; ck(b); N.ust = 5; return;
+    case 5: N.len |= (uint16_t)b << 8; ck(b); N.pos = 0; N.ust = N.len ? 6 : 7;
+            if (N.len > 1024) N.ust = 0;  // panjang tidak wajar: sinkron ulang
+            return;
+    case 6: if (N.pos == 0) N.p0 = b; else if (N.pos == 1) N.p1 = b;
+            ck(b); if (++N.pos >= N.len) N.ust = 7; return;
+    case 7: N.ust = (b == N.ckA) ? 8 : 0; return;
+    case 8: N.ust = 0; if (b == N.ckB) on_ubx(rx_us); return;
+  }
+}
+
+static inline int8_t hexval(uint8_t c){
+  if (c >= '0' && c <= '9') return c - '0';
+  if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+  return -1;
+}
+
+// Kalimat "$G....*CS" dengan checksum cocok (talker GP/GN/GL/GA/GB)
+static void sniff_nmea(uint8_t c){
+  if (c == '$'){ N.nm_on = true; N.nm_star = false; N.nm_x = 0; N.nm_n = 0; N.nm_hex = 0; return; }
+  if (!N.nm_on) return;
+  if (N.nm_star){
+    int8_t h = hexval(c);
+    if (h < 0){ N.nm_on = false; return; }
+    N.nm_ck = (uint8_t)((N.nm_ck << 4) | h);
+    if (++N.nm_hex == 2){
+      N.nm_on = false;
+      if (N.nm_ck == N.nm_x){ s_nmea++; s_last_pvt = false; }
+    }
+    return;
+  }
+  if (c == '*'){ N.nm_star = true; N.nm_ck = 0; N.nm_on = (N.nm_n > 5); return; }
+  if (c < 0x20 || c > 0x7E || ++N.nm_n > NMEA_MAX || (N.nm_n == 1 && c != 'G')){ N.nm_on = false; return; }
+  N.nm_x ^= c;
+}
+
+static void drain(){
+  uint8_t buf[128];
+  uint32_t rx_us;
+  size_t n;
+  while ((n = gps_uart_read(buf, sizeof(buf), rx_us)) > 0)
+    for (size_t i = 0; i < n; ++i){ sniff_ubx(buf[i], rx_us); sniff_nmea(buf[i]); }
+}
+
+// ===== TX =====
+struct ValSet { uint8_t b[64]; uint16_t n; };
+
+static void vs_begin(ValSet& v){
+  v.b[0] = 0x00;   // version
+  v.b[1] = 0x01;   // layer RAM
+  v.b[2] = v.b[3] = 0;
+  v.n = 4;
+}
+
+static void vs_key(ValSet& v, uint32_t key, uint32_t val){
+  uint8_t sz = (uint8_t)((key >> 28) & 7);
+  sz = (sz <= 2) ? 1 : (sz == 3 ? 2 : 4);
+  for (uint8_t i = 0; i < 4; ++i)  v.b[v.n++] = (uint8_t)(key >> (8 * i));
+  for (uint8_t i = 0; i < sz; ++i) v.b[v.n++] = (uint8_t)(val >> (8 * i));
+}
+
+static void ubx_send(uint8_t cls, uint8_t id, const uint8_t* pl, uint16_t len){
+  uint8_t f[8 + sizeof(ValSet::b)];
+  f[0] = 0xB5; f[1] = 0x62; f[2] = cls; f[3] = id;
+  f[4] = (uint8_t)len; f[5] = (uint8_t)(len >> 8);
+  memcpy(f + 6, pl, len);
+  uint8_t a = 0, b = 0;
+  for (uint16_t i = 2; i < 6 + len; ++i){ a += f[i]; b += a; }
+  f[6 + len] = a; f[7 + len] = b;
+  gps_uart_write(f, 8 + len);
+}
+
+static void send_baud(){
+  ValSet v; vs_begin(v);
+  vs_key(v, K_UART1_BAUDRATE, T.baud);
+  ubx_send(UBX_CLS_CFG, UBX_CFG_VALSET, v.b, v.n);
+}
+
+// Fallback untuk firmware tanpa key baud VALSET: port 1, in/out UBX+NMEA (mask bit0 UBX, bit1 NMEA)
+static void send_pubx41(){
+  char pl[48], line[64];
+  snprintf(pl, sizeof(pl), "PUBX,41,1,0003,0003,%lu,0", (unsigned long)T.baud);
+  uint8_t x = 0;
+  for (const char* p = pl; *p; ++p) x ^= (uint8_t)*p;
+  int n = snprintf(line, sizeof(line), "$%s*%02X\r\n", pl, x);
+  gps_uart_write((const uint8_t*)line, (size_t)n);
+}
+
+// Satu transaksi VALSET: diterapkan semua atau tidak sama sekali (NAK)
+static void send_apply(){
+  ValSet v; vs_begin(v);
+  vs_key(v, K_RATE_MEAS, T.meas_ms < 50 ? 50 : T.meas_ms);
+  vs_key(v, K_RATE_NAV, 1);
+  vs_key(v, K_NAVSPG_DYNMODEL, T.dyn_model);
+  vs_key(v, K_MSG_PVT_UART1, 1);
+  vs_key(v, K_UART1OUT_UBX, 1);
+  vs_key(v, K_UART1OUT_NMEA, 0);    // GSV/GSA/... ikut mati: bandwidth hanya untuk PVT
+  ubx_send(UBX_CLS_CFG, UBX_CFG_VALSET, v.b, v.n);
+}
+
+// ===== Mesin state =====
+static void enter(GcState st){
+  s_st = st;
+  s_t_state = millis();
+  s_nmea = s_frames = s_pvt = 0;
+  s_ack = 0;
+}
+
+static uint32_t scan_baud(uint8_t i){ return i ? SCAN_BAUDS[i] : T.baud; }
+
+static GpsCfgResult finish(GpsCfgResult r, const char* why){
+  s_res = r;
+  s_st = GC_DONE;
+  s_dur = millis() - s_t0;
+  if (r == GCR_OK){
+    s_proto = GPS_PROTO_UBX;
+    logf("[GPS] u-blox OK: %lu bd, NAV-PVT %u ms, dyn %u (%lu ms)", (unsigned long)gps_uart_baud(),
+         (unsigned)s_pvt_ms, (unsigned)T.dyn_model, (unsigned long)s_dur);
+  } else if (r == GCR_FALLBACK){
+    s_proto = s_last_pvt ? GPS_PROTO_UBX : GPS_PROTO_NMEA;
+    logf("[GPS] u-blox config incomplete (%s): %lu bd %s", why, (unsigned long)gps_uart_baud(),
+         s_proto == GPS_PROTO_UBX ? "UBX" : "NMEA");
+  } else {
+    gps_uart_set_baud(s_base_baud);
+    s_proto = GPS_PROTO_NMEA;
+    logf("[GPS] No receiver traffic (%lu ms); staying %lu bd NMEA", (unsigned long)s_dur,
+         (unsigned long)s_base_baud);
+  }
+  return r;
+}
+
+static void start_apply(){
+  send_apply();
+  enter(GC_APPLY_ACK);
+}
+
+void gpscfg_begin(const GpsCfgTarget& t){
+  T = t;
+  N = Sniff{};
+  s_base_baud = gps_uart_baud();
+  s_found = 0; s_scan = 0; s_pubx_tried = false;
+  s_acks = s_naks = s_retries = 0; s_pvt_ms = 0;
+  s_proto = GPS_PROTO_NMEA; s_last_pvt = false;
+  s_t0 = millis();
+  gps_uart_set_baud(scan_baud(0));
+  enter(GC_PROBE);
+}
+
+GpsCfgResult gpscfg_poll(){
+  if (s_st == GC_DONE) return s_res;
+  drain();
+  uint32_t dt = millis() - s_t_state;
+  if (millis() - s_t0 >= T.timeout_ms)
+    return s_found ? finish(GCR_FALLBACK, "timeout") : finish(GCR_NO_RX, "");
+
+  switch (s_st){
+    case GC_PROBE:
+      if (s_nmea || s_frames){
+        s_found = gps_uart_baud();
+        logf("[GPS] Receiver @%lu bd (%s)", (unsigned long)s_found, s_frames ? "UBX" : "NMEA");
+        if (s_found == T.baud) start_apply();
+        else { send_baud(); enter(GC_BAUD_SETTLE); }
+        break;
+      }
+      if (dt < PROBE_MS) break;
+      do s_scan = (uint8_t)((s_scan + 1) % N_SCAN);
+      while (s_scan && SCAN_BAUDS[s_scan] == T.baud);
+      gps_uart_set_baud(scan_baud(s_scan));
+      enter(GC_PROBE);
+      break;
+
+    case GC_BAUD_SETTLE:
+      if (dt < SETTLE_MS) break;
+      gps_uart_set_baud(T.baud);
+      enter(GC_BAUD_CHECK);
+      break;
+
+    case GC_BAUD_CHECK:
+      if (s_nmea || s_frames){ start_apply(); break; }
+      if (dt < PROBE_MS) break;
+      gps_uart_set_baud(s_found);   // receiver masih di baud lama
+      if (s_pubx_tried) return finish(GCR_FALLBACK, "baud switch");
+      s_pubx_tried = true;
+      send_pubx41();
+      enter(GC_BAUD_SETTLE);
+      break;
+
+    case GC_APPLY_ACK:
+      if (s_ack == 1){ s_acks++; enter(GC_VERIFY); break; }
+      if (s_ack != 2 && dt < ACK_MS) break;
+      if (s_ack == 2) s_naks++;
+      if (++s_retries > MAX_RETRY) return finish(GCR_FALLBACK, s_ack == 2 ? "NAK" : "no ACK");
+      start_apply();
+      break;
+
+    case GC_VERIFY:
+      if (s_pvt >= 2) s_pvt_ms = (uint16_t)((s_pvt_last_us - s_pvt_first_us) / 1000u / (s_pvt - 1));
+      if (s_pvt >= VERIFY_PVT){
+        // periode jauh dari target: receiver tidak mampu rate ini (mis. modul non-M10)
+        if (s_pvt_ms > T.meas_ms + T.meas_ms / 4) return finish(GCR_FALLBACK, "rate");
+        return finish(GCR_OK, "");
+      }
+      if (dt >= VERIFY_MS) return finish(GCR_FALLBACK, s_pvt ? "rate" : "no NAV-PVT");
+      break;
+
+    case GC_DONE: break;
+  }
+  return GCR_RUNNING;
+}
+
+GpsCfgStatus gpscfg_status(){
+  GpsCfgStatus s;
+  s.res = (s_st == GC_DONE) ? s_res : GCR_RUNNING;
+  s.state = STATE_STR[s_st];
+  s.baud = gps_uart_baud();
+  s.found_baud = s_found;
+  s.proto = s_proto;
+  s.acks = s_acks; s.naks = s_naks; s.retries = s_retries;
+  s.pvt_ms = s_pvt_ms;
+  s.dur_ms = (s_st == GC_DONE) ? s_dur : millis() - s_t0;
+  return s;
+}
+
+const char* gpscfg_result_str(GpsCfgResult r){
+  switch (r){
+    case GCR_RUNNING:  return "running";
+    case GCR_OK:       return "ok";
+    case GCR_FALLBACK: return "fallback";
+    case GCR_NO_RX:    return "no_rx";
+  }
+  return "?";
+}
@@ -0,0 +1,48 @@
+/*
+ * File: gpscfg.h
+ * Description: Non-blocking u-blox receiver auto-configuration (baud detect/switch, rate, dynamic model, NAV-PVT only) driven from the main loop. Generated by AI for clarity.
+ */
+#pragma once
+/* Auto-setup receiver u-blox (M10, CFG-VALSET layer RAM) tanpa delay()/loop tunggu:
+   1. Deteksi baud: coba tiap kandidat, dengar NMEA (checksum valid) atau frame UBX.
+   2. Pindah ke baud target (CFG-UART1-BAUDRATE; fallback $PUBX,41), cek trafik lagi.
+   3. Rate ukur (CFG-RATE-MEAS), dynamic model, output UART1 hanya UBX NAV-PVT
+      (NMEA dimatikan); diulang sampai ACK-ACK.
+   4. Verifikasi: NAV-PVT benar-benar datang dengan periode target.
+   gpscfg_poll() dipanggil berulang (job boot) dan selalu kembali segera; selama
+   konfigurasi, modul ini satu-satunya pembaca ring gps_uart: reader/pipeline baru
+   dimulai setelah hasilnya keluar, dengan protokol dari gpscfg_status().
+   Konfigurasi di RAM receiver: hilang saat receiver mati, diulang tiap boot. */
+#include <Arduino.h>
+#include "gps_read.h"
+
+struct GpsCfgTarget {
+  uint32_t baud;        // baud kerja (mis. 460800)
+  uint16_t meas_ms;     // periode ukur; M10 minimum 50 ms (20 Hz)
+  uint8_t  dyn_model;   // CFG-NAVSPG-DYNMODEL (4 = automotive)
+  uint32_t timeout_ms;  // batas total; lewat -> pakai apa yang sudah terdeteksi
+};
+
+enum GpsCfgResult : uint8_t {
+  GCR_RUNNING = 0,
+  GCR_OK,         // NAV-PVT @ target baud & rate, ACK diterima
+  GCR_FALLBACK,   // receiver terdeteksi tapi konfigurasi tidak lengkap; jalan apa adanya
+  GCR_NO_RX       // tidak ada trafik di baud mana pun
+};
+
+struct GpsCfgStatus {
+  GpsCfgResult res;
+  const char*  state;    // tahap mesin saat ini ("probe", "baud", "apply", ...)
+  uint32_t     baud;     // baud UART sekarang
+  uint32_t     found_baud; // baud awal receiver (0 = belum terdeteksi)
+  GPSProto     proto;    // protokol untuk gps_reader_begin()
+  uint8_t      acks, naks, retries;
+  uint16_t     pvt_ms;   // periode NAV-PVT terukur saat verifikasi (0 = belum)
+  uint32_t     dur_ms;   // lama konfigurasi
+};
+
+// UART sudah dibuka (gps_uart_begin); mulai mesin dari baud kandidat pertama
+void gpscfg_begin(const GpsCfgTarget& t);
+GpsCfgResult gpscfg_poll();   // non-blocking; GCR_RUNNING sampai selesai
+GpsCfgStatus gpscfg_status();
+const char* gpscfg_result_str(GpsCfgResult r);
@@ -0,0 +1,92 @@
+/*
+ * File: host/arduino_shim.cpp
+ * Description: Simulated clock and globals behind the host Arduino shim. Generated by AI for clarity.
+ */
+#include <Arduino.h>
+#include <SD.h>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+static uint32_t s_now_us = 0;
+
+void     host_set_us(uint32_t us) { s_now_us = us; }
+uint32_t micros() { return s_now_us; }
+uint32_t millis() { return s_now_us / 1000u; }
+void     delay(uint32_t ms) { s_now_us += ms * 1000u; }
+
+size_t strlcpy(char* dst, const char* src, size_t size) {
+  size_t n = strlen(src);
+  if (size) {
+    size_t c = (n >= size) ? size - 1 : n;
+    memcpy(dst, src, c);
+    dst[c] = 0;
+  }
+  return n;
+}
+
+// ===== FS di memori =====
+// Sama seperti FAT: rename gagal bila tujuan sudah ada
+static std::map<std::string, std::shared_ptr<std::vector<uint8_t>>> s_files;
+static int s_cut = -1;   // sisa operasi tulis sebelum "daya putus"; -1 = tidak pernah
+
+// true bila operasi tulis boleh jalan (dan memakai satu jatah)
+static bool fs_op() {
+  if (s_cut < 0) return true;
+  if (s_cut == 0) return false;
+  s_cut--;
+  return true;
+}
+
+void host_fs_cut_after(int ops) { s_cut = ops; }
+void host_fs_reset() { s_files.clear(); s_cut = -1; }
+std::vector<uint8_t>* host_fs_data(const char* path) {
+  auto it = s_files.find(path);
+  return it == s_files.end() ? nullptr : it->second.get();
+}
+
+size_t fs::File::read(uint8_t* buf, size_t n) {
+  if (!d_) return 0;
+  n = std::min(n, d_->size() - pos_);
+  memcpy(buf, d_->data() + pos_, n);
+  pos_ += n;
+  return n;
+}
+
+size_t fs::File::write(const uint8_t* buf, size_t n) {
+  if (!d_ || !wr_) return 0;
+  bool last = (s_cut == 1);
+  if (!fs_op()) return 0;
+  if (last) n /= 2;  // daya putus di tengah write: hanya sebagian byte sampai
+  d_->insert(d_->end(), buf, buf + n);
+  return n;
+}
+
+bool fs::FS::exists(const char* path) { return s_files.count(path) != 0; }
+
+fs::File fs::FS::open(const char* path, const char* mode, bool) {
+  bool wr = strcmp(mode, FILE_READ) != 0;
+  auto it = s_files.find(path);
+  if (!wr) return it == s_files.end() ? File() : File(it->second, false);
+  if (!fs_op()) return File();
+  auto d = std::make_shared<std::vector<uint8_t>>();
+  if (!strcmp(mode, FILE_APPEND) && it != s_files.end()) *d = *it->second;
+  s_files[path] = d;
+  return File(d, true);
+}
+
+bool fs::FS::remove(const char* path) {
+  if (!s_files.count(path) || !fs_op()) return false;
+  s_files.erase(path);
+  return true;
+}
+
+bool fs::FS::rename(const char* from, const char* to) {
+  if (!s_files.count(from) || s_files.count(to) || !fs_op()) return false;
+  s_files[to] = s_files[from];
+  s_files.erase(from);
+  return true;
+}
+
+fs::FS SD;
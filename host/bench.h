@@ -0,0 +1,59 @@
+/*
+ * File: host/bench.h
+ * Description: Tiny microbenchmark harness: auto-calibrated loops, ns/op, TSC cycle estimate, baseline check. Generated by AI for clarity.
+ */
+#pragma once
+#include <stdint.h>
+#include <chrono>
+#include <string>
+#include <vector>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+struct BenchResult {
+  std::string name;
+  double ns_op;
+  double cyc_op;  // siklus TSC per op; <0 jika tidak tersedia
+};
+
+// Cegah compiler membuang hasil kernel
+template <typename T>
+inline void bench_keep(const T& v) { asm volatile("" : : "r,m"(v) : "memory"); }
+
+inline uint64_t bench_cycles() {
+#if defined(__x86_64__) || defined(__i386__)
+  return __rdtsc();
+#else
+  return 0;
+#endif
+}
+
+// Jalankan fn(iters) berulang: kalibrasi sampai ~20 ms per sampel, ambil min dari 7 sampel.
+// fn harus mengerjakan tepat `iters` operasi.
+template <typename Fn>
+BenchResult bench_run(const char* name, Fn&& fn) {
+  using clk = std::chrono::steady_clock;
+  uint64_t iters = 16;
+  for (;;) {
+    auto t0 = clk::now();
+    fn(iters);
+    double s = std::chrono::duration<double>(clk::now() - t0).count();
+    if (s > 0.02 || iters > (1ull << 34)) break;
+    iters *= (s < 0.002) ? 8 : 2;
+  }
+  double best_ns = 1e30, best_cyc = 1e30;
+  for (int k = 0; k < 7; ++k) {
+    uint64_t c0 = bench_cycles();
+    auto t0 = clk::now();
+    fn(iters);
+    double ns = std::chrono::duration<double, std::nano>(clk::now() - t0).count() / (double)iters;
+    double cyc = (double)(bench_cycles() - c0) / (double)iters;
+    if (ns < best_ns) { best_ns = ns; best_cyc = cyc; }
+  }
+  return {name, best_ns, bench_cycles() ? best_cyc : -1.0};
+}
+
+// Kernel per modul (bench_gps.cpp / bench_race.cpp)
+void bench_gps(std::vector<BenchResult>& out);
+void bench_race(std::vector<BenchResult>& out);
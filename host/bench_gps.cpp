@@ -0,0 +1,109 @@
+/*
+ * File: host/bench_gps.cpp
+ * Description: Microbenchmarks for gps_read kernels (NMEA/UBX feed, dm_to_e7, med3, speed filter, epoch). Generated by AI for clarity.
+ */
+// Sertakan TU langsung agar kernel static bisa diukur tanpa mengubah API firmware
+#include "../gps_read.cpp"
+#include "bench.h"
+#include "host_sim.h"
+#include "../timebase.h"
+
+static std::string nmea(const char* body) {
+  uint8_t x = 0;
+  for (const char* p = body; *p; ++p) x ^= (uint8_t)*p;
+  char b[160];
+  snprintf(b, sizeof(b), "$%s*%02X\r\n", body, x);
+  return b;
+}
+
+static std::vector<uint8_t> ubx_pvt_frame() {
+  std::vector<uint8_t> f = {0xB5, 0x62, 0x01, 0x07, 92, 0};
+  uint8_t p[92] = {0};
+  uint32_t itow = 36000000, lon = (uint32_t)1127521000, lat = (uint32_t)(int32_t)-72575000;
+  memcpy(p + 0, &itow, 4);
+  p[20] = 3; p[21] = 0x01; p[23] = 14;
+  memcpy(p + 24, &lon, 4);
+  memcpy(p + 28, &lat, 4);
+  f.insert(f.end(), p, p + 92);
+  uint8_t a = 0, b = 0;
+  for (size_t i = 2; i < f.size(); ++i) { a += f[i]; b += a; }
+  f.push_back(a); f.push_back(b);
+  return f;
+}
+
+void bench_gps(std::vector<BenchResult>& out) {
+  gps_reader_begin(160, GPS_PROTO_NMEA);
+  const std::string gga = nmea("GNGGA,100000.00,0715.45000,S,11245.12600,E,1,14,0.8,100.0,M,0.0,M,,");
+  const std::string rmc = nmea("GNRMC,100000.00,A,0715.45000,S,11245.12600,E,38.877,12.3,170826,,,A");
+
+  out.push_back(bench_run("nmea_feed_gga", [&](uint64_t n) {
+    for (uint64_t i = 0; i < n; ++i)
+      for (char c : gga) bench_keep(nmea_feed((uint8_t)c));
+  }));
+  out.push_back(bench_run("nmea_feed_rmc", [&](uint64_t n) {
+    for (uint64_t i = 0; i < n; ++i)
+      for (char c : rmc) bench_keep(nmea_feed((uint8_t)c));
+  }));
+
+  const std::vector<uint8_t> pvt = ubx_pvt_frame();
+  out.push_back(bench_run("ubx_feed_pvt", [&](uint64_t n) {
+    for (uint64_t i = 0; i < n; ++i)
+      for (uint8_t c : pvt) bench_keep(ubx_feed(c));
+  }));
+
+  // input bervariasi agar tidak terlipat jadi konstanta
+  NmeaNum dmv[64];
+  float sp[64];
+  for (int i = 0; i < 64; ++i) {
+    dmv[i] = NmeaNum{71545000u + (uint32_t)i * 137u, 5, true, false, true, '7'};  // 0715.45000 ...
+    sp[i] = 10.0f + (i % 7) * 0.3f - (i % 3) * 0.2f;
+  }
+
+  out.push_back(bench_run("dm_to_e7", [&](uint64_t n) {
+    for (uint64_t i = 0; i < n; ++i) bench_keep(dm_to_e7(dmv[i & 63]));
+  }));
+  out.push_back(bench_run("med3", [&](uint64_t n) {
+    for (uint64_t i = 0; i < n; ++i) bench_keep(med3(sp[i & 63], sp[(i + 1) & 63], sp[(i + 2) & 63]));
+  }));
+  out.push_back(bench_run("filter_speed", [&](uint64_t n) {
+    for (uint64_t i = 0; i < n; ++i) { filter_speed(sp[i & 63], 0.1f); bench_keep(sog_filt); }
+  }));
+
+  // End-to-end satu epoch NMEA (GGA+RMC) lewat gps_poll; termasuk overhead shim UART host
+  std::vector<std::string> ep;
+  for (int i = 0; i < 64; ++i) {
+    char hms[16], body[160];
+    unsigned t = 100000u * 0 + i;  // detik ke-i
+    snprintf(hms, sizeof(hms), "10%02u%02u.%02u", (t / 600) % 60, (t / 10) % 60, (t % 10) * 10);
+    snprintf(body, sizeof(body), "GNGGA,%s,0715.%05u,S,11245.12600,E,1,14,0.8,100.0,M,0.0,M,,", hms, 45000 + i * 97);
+    std::string s = nmea(body);
+    snprintf(body, sizeof(body), "GNRMC,%s,A,0715.%05u,S,11245.12600,E,38.877,0.0,170826,,,A", hms, 45000 + i * 97);
+    ep.push_back(s + nmea(body));
+  }
+  host_uart_clear();
+  gps_reader_begin(160, GPS_PROTO_NMEA);
+  uint32_t us = 1000000;
+  out.push_back(bench_run("gps_poll_epoch_nmea", [&](uint64_t n) {
+    GPSFix fx;
+    for (uint64_t i = 0; i < n; ++i) {
+      const std::string& s = ep[i & 63];
+      us += 100000;
+      host_set_us(us);
+      host_uart_push((const uint8_t*)s.data(), s.size(), us);
+      while (gps_poll(fx)) bench_keep(fx.sog_mps);
+    }
+  }));
+
+  timebase_reset(86400000u);
+  uint32_t g = 36000000, rx = 1000000;
+  out.push_back(bench_run("timebase_observe", [&](uint64_t n) {
+    uint32_t o = 0;
+    for (uint64_t i = 0; i < n; ++i) {
+      g += 100; rx += 100000 + (uint32_t)(i * 2654435761u >> 22);  // jitter 0..~1 ms
+      if (g >= 86400000u) g -= 86400000u;
+      timebase_observe(g, rx);
+      timebase_to_us(g, rx, o);
+      bench_keep(o);
+    }
+  }));
+}
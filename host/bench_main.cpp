@@ -0,0 +1,71 @@
+/*
+ * File: host/bench_main.cpp
+ * Description: Runs all kernel microbenchmarks, prints ns/op and cycles/op, and checks against a stored baseline. Generated by AI for clarity.
+ */
+/* Pemakaian:
+     racebox_bench [--baseline FILE] [--tolerance R] [--write-baseline FILE] [--filter SUBSTR]
+   --baseline: gagal (exit 1) jika ns/op kernel > baseline * R (default R = 1.5)
+   --write-baseline: simpan hasil run ini sebagai baseline baru
+   Baseline bergantung mesin; buat ulang di runner CI sebelum dipakai sebagai gate. */
+#include <Arduino.h>
+#include "bench.h"
+#include <map>
+
+int main(int argc, char** argv) {
+  const char* base_path = nullptr;
+  const char* write_path = nullptr;
+  const char* filter = nullptr;
+  double tol = 1.5;
+  for (int i = 1; i < argc; ++i) {
+    std::string a = argv[i];
+    if (i + 1 >= argc) { fprintf(stderr, "missing value for %s\n", a.c_str()); return 2; }
+    if (a == "--baseline") base_path = argv[++i];
+    else if (a == "--write-baseline") write_path = argv[++i];
+    else if (a == "--tolerance") tol = atof(argv[++i]);
+    else if (a == "--filter") filter = argv[++i];
+    else { fprintf(stderr, "unknown option %s\n", a.c_str()); return 2; }
+  }
+
+  std::map<std::string, double> base;
+  if (base_path) {
+    FILE* f = fopen(base_path, "r");
+    if (!f) { fprintf(stderr, "cannot open baseline %s\n", base_path); return 2; }
+    char line[256], name[128];
+    double ns;
+    while (fgets(line, sizeof(line), f))
+      if (line[0] != '#' && sscanf(line, "%127s %lf", name, &ns) == 2) base[name] = ns;
+    fclose(f);
+  }
+
+  std::vector<BenchResult> all, res;
+  bench_gps(all);
+  bench_race(all);
+  for (const BenchResult& r : all)
+    if (!filter || r.name.find(filter) != std::string::npos) res.push_back(r);
+
+  int fail = 0;
+  printf("%-22s %10s %10s %10s %7s\n", "kernel", "ns/op", "cyc/op", "base_ns", "ratio");
+  for (const BenchResult& r : res) {
+    char cyc[16] = "-", bs[16] = "-", ratio[16] = "-";
+    if (r.cyc_op >= 0) snprintf(cyc, sizeof(cyc), "%.1f", r.cyc_op);
+    const char* st = "";
+    auto it = base.find(r.name);
+    if (it != base.end() && it->second > 0) {
+      double q = r.ns_op / it->second;
+      snprintf(bs, sizeof(bs), "%.2f", it->second);
+      snprintf(ratio, sizeof(ratio), "%.2f", q);
+      if (q > tol) { st = "  REGRESSION"; fail++; }
+    }
+    printf("%-22s %10.2f %10s %10s %7s%s\n", r.name.c_str(), r.ns_op, cyc, bs, ratio, st);
+  }
+
+  if (write_path) {
+    FILE* f = fopen(write_path, "w");
+    if (!f) { fprintf(stderr, "cannot write %s\n", write_path); return 2; }
+    fprintf(f, "# kernel ns_per_op (racebox_bench --write-baseline)\n");
+    for (const BenchResult& r : res) fprintf(f, "%s %.2f\n", r.name.c_str(), r.ns_op);
+    fclose(f);
+  }
+  if (fail) printf("%d kernel(s) slower than %.2fx baseline\n", fail, tol);
+  return fail ? 1 : 0;
+}
@@ -0,0 +1,115 @@
+/*
+ * File: host/bench_race.cpp
+ * Description: Microbenchmarks for race kernels (ENU step vs haversine, segment crossing engine, race_update per fix, run trace, deferred log). Generated by AI for clarity.
+ */
+// Sertakan TU langsung agar kernel static bisa diukur tanpa mengubah API firmware
+#include "../race.cpp"
+#include "bench.h"
+#include "host_sim.h"
+
+static double hav_ref(double lat1, double lon1, double lat2, double lon2) {
+  static constexpr double R = 6371000.0;
+  double r1 = lat1 * M_PI / 180.0, r2 = lat2 * M_PI / 180.0;
+  double dlat = (lat2 - lat1) * M_PI / 180.0, dlon = (lon2 - lon1) * M_PI / 180.0;
+  double a = sin(dlat / 2) * sin(dlat / 2) + cos(r1) * cos(r2) * sin(dlon / 2) * sin(dlon / 2);
+  return R * 2 * atan2(sqrt(a), sqrt(1 - a));
+}
+
+void bench_race(std::vector<BenchResult>& out) {
+  double lat[65], lon[65];
+  for (int i = 0; i < 65; ++i) { lat[i] = -7.2575 + i * 1.8e-5; lon[i] = 112.7521 + i * 3e-6; }
+  // Pembanding: haversine double yang dulu dipakai race_update() per fix
+  out.push_back(bench_run("haversine_ref", [&](uint64_t n) {
+    for (uint64_t i = 0; i < n; ++i) {
+      size_t k = i & 63;
+      bench_keep(hav_ref(lat[k], lon[k], lat[k + 1], lon[k + 1]));
+    }
+  }));
+  // Per fix sekarang: proyeksi ke frame ENU + jarak float dari titik sebelumnya
+  int32_t lat7[65], lon7[65];
+  for (int i = 0; i < 65; ++i) { lat7[i] = (int32_t)lround(lat[i] * 1e7); lon7[i] = (int32_t)lround(lon[i] * 1e7); }
+  GeoFrame gf;
+  geo_frame_begin(gf, lat7[0], lon7[0]);
+  out.push_back(bench_run("geo_enu_step", [&](uint64_t n) {
+    float pe = 0, pn = 0;
+    for (uint64_t i = 0; i < n; ++i) {
+      size_t k = (i & 63) + 1;
+      float e, nn;
+      geo_enu(gf, lat7[k], lon7[k], e, nn);
+      bench_keep(geo_dist_m(pe, pn, e, nn));
+      pe = e; pn = nn;
+    }
+  }));
+
+  host_log_enable(false);
+  race_cfg() = RaceConfig{};
+  race_begin();
+  TraceSample sa{100000u, 200.0f, 20.0f, lat7[0], lon7[0]}, sb{200000u, 202.0f, 20.0f, lat7[0], lon7[0]};
+  out.push_back(bench_run("interp_seg", [&](uint64_t n) {
+    for (uint64_t i = 0; i < n; ++i) bench_keep(interp_seg(sa, sb, 201.0f + (i & 1) * 0.5f));
+  }));
+  // segmen tanpa edge: cursor menunjuk edge berikutnya di depan segmen
+  s_edge_i = 0;
+  while (s_edge_i < s_edges.size() && s_edges[s_edge_i].at_m <= sb.dist_m) s_edge_i++;
+  out.push_back(bench_run("resolve_edges_miss", [&](uint64_t n) {
+    for (uint64_t i = 0; i < n; ++i) { resolve_edges(sa, sb); bench_keep(s_edge_i); }
+  }));
+
+  // race_update di tengah run: ring penuh, sebagian trap sudah lewat, sisanya belum
+  auto midrun = [&](const char* name) {
+    race_begin();
+    GPSFix fx{};
+    fx.valid = true; fx.fixQ = 1; fx.hdop = 0.8f; fx.hacc_m = -1; fx.sacc_mps = -1;
+    fx.sog_mps = 20.0f; fx.lat_e7 = lat7[0]; fx.lon_e7 = lon7[0]; fx.t_us = 1000000;
+    race_update(fx);  // arm + start
+    const int32_t dlat = 145;  // ~1.6 m per fix ke utara (1e-7 deg)
+    while (RS.cum_dist_m < 250.0f) {
+      fx.t_us += 100000;
+      fx.lat_e7 += dlat;
+      race_update(fx);
+    }
+    // posisi ditahan: jarak tetap, trap di depan tidak pernah tercapai selama bench
+    out.push_back(bench_run(name, [&](uint64_t n) {
+      for (uint64_t i = 0; i < n; ++i) {
+        fx.t_us += 100000;
+        race_update(fx);
+        bench_keep(RS.cum_dist_m);
+      }
+    }));
+  };
+  midrun("race_update_midrun");
+  // split tiap 10 m sampai 480 m (48 trap + window): biaya per fix harus tetap sama
+  race_cfg().traps.clear();
+  for (int k = 1; k <= 48; ++k) race_cfg().traps.push_back({String("s") + String(k), k * 10.0f, 4.0f});
+  midrun("race_update_48traps");
+  race_cfg() = RaceConfig{};
+
+  // Jejak run: push 20 Hz (termasuk decimate teramortisasi) & query jarak acak
+  TraceSample ts{0, 0.0f, 20.0f, lat7[0], lon7[0]};
+  trace_reset();
+  out.push_back(bench_run("trace_push", [&](uint64_t n) {
+    for (uint64_t i = 0; i < n; ++i) {
+      ts.t_us += 50000; ts.dist_m += 1.0f; ts.lat_e7 += 90;
+      trace_push(ts);
+    }
+    bench_keep(trace_size());
+  }));
+  trace_reset();
+  ts = TraceSample{0, 0.0f, 20.0f, lat7[0], lon7[0]};
+  for (int i = 0; i < 1000; ++i) { ts.t_us += 50000; ts.dist_m += 1.0f; ts.lat_e7 += 90; trace_push(ts); }
+  out.push_back(bench_run("trace_find_dist", [&](uint64_t n) {
+    TraceSample a, b;
+    for (uint64_t i = 0; i < n; ++i) bench_keep(trace_find_dist(0.5f + (float)((i * 37) % 998), a, b));
+  }));
+  // Log crossing trap di jalur panas: record biner vs format teks yang ditunda ke idle slice
+  out.push_back(bench_run("dlog_trap_event", [&](uint64_t n) {
+    for (uint64_t i = 0; i < n; ++i) dlog_s(DL_TRAP_ET, "1/4mi", dlog_f(402.336f), dlog_f(20.1168f + i * 1e-4f));
+  }));
+  out.push_back(bench_run("dlog_drain_trap", [&](uint64_t n) {
+    for (uint64_t i = 0; i < n; ++i) {
+      dlog_s(DL_TRAP_ET, "1/4mi", dlog_f(402.336f), dlog_f(20.1168f));
+      bench_keep(dlog_drain());
+    }
+  }));
+  host_log_enable(true);
+}
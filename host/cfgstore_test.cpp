@@ -0,0 +1,122 @@
+/*
+ * File: host/cfgstore_test.cpp
+ * Description: Host checks for the write-behind config store: coalescing, idle gating, power cuts at every write step and CRC fallback. Generated by AI for clarity.
+ */
+/* Pemakaian: racebox_cfgstore_test [-v]
+   Semua di FS memori shim (host_sim.h). Uji putus daya: untuk setiap jumlah operasi
+   tulis N, daya diputus setelah N operasi saat menyimpan isi baru; setelah "boot
+   ulang" cfgstore_read() harus mengembalikan isi lama atau isi baru, utuh. */
+#include <Arduino.h>
+#include "../cfgstore.h"
+#include "host_sim.h"
+#include <SD.h>
+#include <string>
+
+static const char* PATH = "/config/race.json";
+static uint32_t s_now_ms = 1;
+static int s_fail = 0;
+
+static void advance(uint32_t ms) { s_now_ms += ms; host_set_us(s_now_ms * 1000u); }
+
+static void check(bool ok, const char* what) {
+  printf("%s %s\n", ok ? "PASS" : "FAIL", what);
+  if (!ok) s_fail++;
+}
+
+static void put(const std::string& s) { cfgstore_put(PATH, s.data(), s.size()); }
+
+// Tunggu jendela tenang lalu satu slice idle
+static bool flush() { advance(2100); return cfgstore_poll(true); }
+
+static std::string read_back(CfgSource* src = nullptr, bool (*accept)(const char*, size_t) = nullptr) {
+  static char buf[CFGSTORE_READ_BYTES];
+  size_t n;
+  CfgSource s = cfgstore_read(PATH, buf, sizeof(buf), n, accept);
+  if (src) *src = s;
+  return s == CFG_SRC_NONE ? std::string("<none>") : std::string(buf, n);
+}
+
+static bool reject_old(const char* d, size_t n) { return std::string(d, n) != "{\"v\":\"old\"}"; }
+
+int main(int argc, char** argv) {
+  bool verbose = argc > 1 && !strcmp(argv[1], "-v");
+  host_log_enable(verbose);
+  advance(0);
+  cfgstore_begin(2000);
+
+  // ===== Gabung & gating =====
+  put("{\"v\":1}");
+  advance(500);
+  put("{\"v\":2}");
+  advance(1000);
+  check(!cfgstore_poll(true), "no write inside quiet window");
+  advance(1100);
+  check(!cfgstore_poll(false), "no write while not idle");
+  check(cfgstore_poll(true), "write in idle slice after quiet window");
+  CfgStoreStats st = cfgstore_stats();
+  check(st.puts == 2 && st.writes == 1 && st.pending == 0, "two edits coalesced into one write");
+  check(read_back() == "{\"v\":2}", "latest edit persisted");
+  check(!host_fs_data("/config/race.json.tmp"), "tmp renamed away");
+
+  put("{\"v\":3}");
+  flush();
+  CfgSource src;
+  check(read_back(&src) == "{\"v\":3}" && src == CFG_SRC_PRIMARY, "second save replaces primary");
+  check(host_fs_data("/config/race.json.bak") != nullptr, "previous copy kept as backup");
+
+  // ===== Putus daya di tiap langkah =====
+  const std::string OLD = "{\"v\":\"old\"}", NEW = "{\"v\":\"new\"}";
+  int steps_ok = 0, n_steps = 0;
+  for (int cut = 0; cut < 20; ++cut) {
+    host_fs_reset();
+    put("{\"v\":\"older\"}"); flush();
+    put(OLD); flush();
+    put(NEW);
+    uint32_t e0 = cfgstore_stats().errors;
+    host_fs_cut_after(cut);
+    bool wrote = flush() && cfgstore_stats().errors == e0;
+    host_fs_cut_after(-1);  // boot ulang, daya normal
+    std::string got = read_back(&src);
+    bool ok = (got == OLD || got == NEW);
+    if (verbose || !ok) printf("  cut after %2d ops: %-13s from %s\n", cut, got.c_str(), cfgstore_source_str(src));
+    steps_ok += ok ? 1 : 0;
+    n_steps++;
+    if (got == NEW && src == CFG_SRC_PRIMARY && wrote) break;  // urutan lengkap
+  }
+  check(steps_ok == n_steps, "power cut at any step leaves old or new copy intact");
+
+  // ===== Salinan rusak / lama =====
+  host_fs_reset();
+  put(OLD); flush();
+  put(NEW); flush();
+  (*host_fs_data(PATH))[3] ^= 0x20;   // bit flip di primary
+  std::string got = read_back(&src);
+  check(got == OLD && src == CFG_SRC_BACKUP, "corrupt primary falls back to backup");
+  check(cfgstore_stats().pending == 1, "restored copy queued to repair primary");
+  flush();
+  check(read_back(&src) == OLD && src == CFG_SRC_PRIMARY, "primary repaired in next idle slice");
+
+  host_fs_reset();
+  put(OLD); flush();
+  put(NEW); flush();
+  got = read_back(&src, reject_old);
+  check(got == NEW && src == CFG_SRC_PRIMARY, "parser accepts primary");
+  (*host_fs_data(PATH))[0] = 'x';
+  got = read_back(&src, reject_old);
+  check(got == "<none>", "no copy accepted -> defaults");
+
+  host_fs_reset();
+  {
+    File f = SD.open(PATH, FILE_WRITE);
+    const char legacy[] = "{\"arm_speed_kph\":1}\n";
+    f.write((const uint8_t*)legacy, sizeof(legacy) - 1);
+    f.close();
+  }
+  got = read_back(&src);
+  check(got == "{\"arm_speed_kph\":1}\n" && src == CFG_SRC_PRIMARY, "legacy file without trailer still loads");
+
+  std::string big(CFGSTORE_MAX_BYTES + 1, ' ');
+  check(!cfgstore_put(PATH, big.data(), big.size()), "oversized config rejected");
+
+  return s_fail ? 1 : 0;
+}
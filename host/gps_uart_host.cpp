@@ -0,0 +1,60 @@
+/*
+ * File: host/gps_uart_host.cpp
+ * Description: Host implementation of gps_uart: bursts are pushed by the replay instead of a UART callback. Generated by AI for clarity.
+ */
+#include "../gps_uart.h"
+#include "host_sim.h"
+#include <deque>
+#include <vector>
+
+struct Burst { std::vector<uint8_t> data; size_t pos; uint32_t rx_us; };
+static std::deque<Burst> s_q;
+static GPSUartStats ST;
+static std::vector<uint8_t> s_tx;
+static uint32_t s_baud = 0;
+
+void host_uart_push(const uint8_t* data, size_t n, uint32_t rx_us) {
+  s_q.push_back({std::vector<uint8_t>(data, data + n), 0, rx_us});
+  ST.bursts++;
+  ST.bytes += n;
+}
+
+void host_uart_clear() { s_q.clear(); s_tx.clear(); ST = GPSUartStats{}; }
+
+size_t host_uart_take_tx(uint8_t* dst, size_t n) {
+  n = std::min(n, s_tx.size());
+  memcpy(dst, s_tx.data(), n);
+  s_tx.erase(s_tx.begin(), s_tx.begin() + n);
+  return n;
+}
+
+bool gps_uart_begin(uint32_t baud, int, int) { s_baud = baud; return true; }
+
+size_t gps_uart_write(const uint8_t* src, size_t n) {
+  s_tx.insert(s_tx.end(), src, src + n);
+  return n;
+}
+
+void gps_uart_set_baud(uint32_t baud) { s_baud = baud; }
+uint32_t gps_uart_baud() { return s_baud; }
+
+size_t gps_uart_read(uint8_t* dst, size_t n, uint32_t& rx_us) {
+  while (!s_q.empty() && s_q.front().pos >= s_q.front().data.size()) s_q.pop_front();
+  if (s_q.empty()) return 0;
+  Burst& b = s_q.front();
+  n = std::min(n, b.data.size() - b.pos);
+  memcpy(dst, b.data.data() + b.pos, n);
+  b.pos += n;
+  rx_us = b.rx_us;
+  return n;
+}
+
+size_t gps_uart_available() {
+  size_t n = 0;
+  for (const Burst& b : s_q) n += b.data.size() - b.pos;
+  return n;
+}
+
+bool gps_uart_wait(uint32_t) { return !s_q.empty(); }
+
+const GPSUartStats& gps_uart_stats() { return ST; }
@@ -0,0 +1,281 @@
+/*
+ * File: host/gpscfg_sim.cpp
+ * Description: Drives the gpscfg state machine against a simulated u-blox M10 receiver (baud, VALSET/ACK, PUBX,41, NMEA/NAV-PVT output) on the host clock. Generated by AI for clarity.
+ */
+/* Pemakaian:
+     racebox_gpscfg_sim [opsi]
+       --rx-baud N            baud awal receiver (default 9600 = pabrik)
+       --rx-ubx               receiver sudah terkonfigurasi: hanya NAV-PVT @ 20 Hz
+       --no-rx                tidak ada receiver (UART diam)
+       --nak-rate             receiver menolak (NAK) VALSET dengan CFG-RATE-MEAS
+       --no-valset-baud       receiver menolak key baud (hanya $PUBX,41 yang bisa)
+       --poll-ms N            jeda gpscfg_poll() (default 20 = job boot)
+       --expect R             ok | fallback | no_rx
+       --expect-baud N        baud UART akhir
+       --expect-proto P       ubx | nmea
+       --expect-pvt-ms N      periode NAV-PVT terukur (toleransi 2 ms)
+       --expect-epochs N      minimal epoch dari gps_poll() selama 2 s setelah config
+       --max-ms N             konfigurasi harus selesai dalam N ms
+       -v                     cetak perintah yang diterima receiver
+   Byte hanya sampai bila baud kedua sisi sama; beda baud -> sampah di kedua arah. */
+#include <Arduino.h>
+#include "../gpscfg.h"
+#include "../gps_read.h"
+#include "../gps_uart.h"
+#include "host_sim.h"
+#include <string>
+#include <vector>
+
+struct Opts {
+  uint32_t rx_baud = 9600;
+  bool     rx_ubx = false, no_rx = false, nak_rate = false, no_valset_baud = false, verbose = false;
+  uint32_t poll_ms = 20;
+  const char* expect = nullptr;
+  const char* expect_proto = nullptr;
+  long     expect_baud = -1, expect_pvt_ms = -1, expect_epochs = -1, max_ms = -1;
+};
+
+// ===== Receiver simulasi =====
+struct SimRx {
+  uint32_t baud = 9600;
+  bool     nmea_out = true, pvt_out = false;
+  uint16_t meas_ms = 1000;
+  uint8_t  dyn = 0;
+  uint32_t next_us = 0;
+  uint32_t seed = 12345;
+  // parser TX firmware -> receiver
+  std::vector<uint8_t> ubx;     // frame UBX yang sedang dirakit
+  std::string nmea;
+  uint32_t valsets = 0, pubx = 0;
+};
+
+static Opts  O;
+static SimRx R;
+
+static void deliver(const uint8_t* p, size_t n, uint32_t t_us) {
+  if (O.no_rx || !n) return;
+  if (gps_uart_baud() == R.baud) { host_uart_push(p, n, t_us); return; }
+  std::vector<uint8_t> junk(n / 2 + 1);  // baud salah: byte rusak, jumlah tidak sama
+  for (uint8_t& b : junk) { R.seed = R.seed * 1103515245u + 12345u; b = (uint8_t)(R.seed >> 16); }
+  host_uart_push(junk.data(), junk.size(), t_us);
+}
+
+static void ubx_frame(std::vector<uint8_t>& out, uint8_t cls, uint8_t id, const uint8_t* pl, uint16_t len) {
+  size_t s = out.size();
+  out.insert(out.end(), {0xB5, 0x62, cls, id, (uint8_t)len, (uint8_t)(len >> 8)});
+  out.insert(out.end(), pl, pl + len);
+  uint8_t a = 0, b = 0;
+  for (size_t i = s + 2; i < out.size(); ++i) { a += out[i]; b += a; }
+  out.push_back(a); out.push_back(b);
+}
+
+static void nmea_line(std::vector<uint8_t>& out, const char* body) {
+  uint8_t x = 0;
+  for (const char* p = body; *p; ++p) x ^= (uint8_t)*p;
+  char line[128];
+  int n = snprintf(line, sizeof(line), "$%s*%02X\r\n", body, x);
+  out.insert(out.end(), line, line + n);
+}
+
+static void put4(uint8_t* p, uint32_t v) { for (int i = 0; i < 4; ++i) p[i] = (uint8_t)(v >> (8 * i)); }
+
+// Satu epoch output receiver (diam, fix 3D bagus)
+static void emit_epoch(uint32_t t_us) {
+  std::vector<uint8_t> out;
+  uint32_t ms = t_us / 1000;
+  if (R.nmea_out) {
+    char b[128], tod[16];
+    snprintf(tod, sizeof(tod), "%02lu%02lu%02lu.%02lu", (unsigned long)(ms / 3600000 % 24),
+             (unsigned long)(ms / 60000 % 60), (unsigned long)(ms / 1000 % 60), (unsigned long)(ms / 10 % 100));
+    snprintf(b, sizeof(b), "GNGGA,%s,0613.0000,S,10649.0000,E,1,12,0.8,10.0,M,0.0,M,,", tod);
+    nmea_line(out, b);
+    nmea_line(out, "GNGSA,A,3,01,02,03,04,05,06,07,08,09,10,11,12,1.4,0.8,1.1,1");
+    nmea_line(out, "GPGSV,3,1,12,01,40,083,46,02,17,308,41,03,07,344,39,04,22,228,45,1");
+    snprintf(b, sizeof(b), "GNRMC,%s,A,0613.0000,S,10649.0000,E,0.0,0.0,170526,,,A,V", tod);
+    nmea_line(out, b);
+  }
+  if (R.pvt_out) {
+    uint8_t pl[92] = {};
+    put4(pl + 0, ms);          // iTOW
+    pl[20] = 3; pl[21] = 0x01; // fix 3D, gnssFixOK
+    pl[23] = 12;               // numSV
+    put4(pl + 40, 400);        // hAcc mm
+    put4(pl + 68, 150);        // sAcc mm/s
+    pl[76] = 120;              // pDOP 1.20
+    ubx_frame(out, 0x01, 0x07, pl, sizeof(pl));
+  }
+  deliver(out.data(), out.size(), t_us + 15000);  // byte tiba ~15 ms setelah epoch
+}
+
+static uint8_t key_size(uint32_t k) {
+  uint8_t s = (uint8_t)((k >> 28) & 7);
+  return s <= 2 ? 1 : (s == 3 ? 2 : 4);
+}
+
+// CFG-VALSET: semua key diterapkan atau NAK
+static void on_valset(const std::vector<uint8_t>& f, uint32_t t_us) {
+  uint16_t len = (uint16_t)(f[4] | (f[5] << 8));
+  const uint8_t* p = f.data() + 6;
+  SimRx nx = R;
+  uint32_t new_baud = 0;
+  bool ok = len >= 4;
+  for (uint16_t i = 4; ok && i + 4 <= len;) {
+    uint32_t k = p[i] | (p[i + 1] << 8) | (p[i + 2] << 16) | ((uint32_t)p[i + 3] << 24);
+    uint8_t sz = key_size(k);
+    uint32_t v = 0;
+    for (uint8_t j = 0; j < sz; ++j) v |= (uint32_t)p[i + 4 + j] << (8 * j);
+    i += 4 + sz;
+    if (O.verbose) printf("  rx VALSET key %08lx = %lu\n", (unsigned long)k, (unsigned long)v);
+    switch (k) {
+      case 0x40520001u: if (O.no_valset_baud) ok = false; else new_baud = v; break;
+      case 0x30210001u: if (O.nak_rate) ok = false; else nx.meas_ms = (uint16_t)v; break;
+      case 0x30210002u: break;
+      case 0x20110021u: nx.dyn = (uint8_t)v; break;
+      case 0x20910007u: nx.pvt_out = v != 0; break;
+      case 0x10740001u: if (!v) nx.pvt_out = false; break;
+      case 0x10740002u: nx.nmea_out = v != 0; break;
+      default: ok = false;
+    }
+  }
+  R.valsets++;
+  std::vector<uint8_t> ack;
+  uint8_t pl[2] = {0x06, 0x8A};
+  ubx_frame(ack, 0x05, ok ? 0x01 : 0x00, pl, 2);
+  deliver(ack.data(), ack.size(), t_us);   // ACK masih di baud lama
+  if (!ok) return;
+  if (nx.meas_ms != R.meas_ms) nx.next_us = t_us + nx.meas_ms * 1000u;
+  nx.baud = new_baud ? new_baud : R.baud;
+  nx.valsets = R.valsets;
+  R = nx;
+}
+
+static void on_nmea_cmd(const std::string& s) {
+  if (O.verbose) printf("  rx %s\n", s.c_str());
+  unsigned port, in, out; unsigned long baud;
+  if (sscanf(s.c_str(), "$PUBX,41,%u,%x,%x,%lu", &port, &in, &out, &baud) == 4 && port == 1) {
+    R.pubx++;
+    R.baud = (uint32_t)baud;
+    R.nmea_out = (out & 2) != 0;   // mask: bit0 UBX, bit1 NMEA
+    if (!(out & 1)) R.pvt_out = false;
+  }
+}
+
+// Byte dari firmware ke receiver
+static void rx_feed(uint32_t t_us) {
+  uint8_t b[256];
+  size_t n;
+  while ((n = host_uart_take_tx(b, sizeof(b))) > 0) {
+    if (O.no_rx || gps_uart_baud() != R.baud) continue;  // beda baud: receiver terima sampah
+    for (size_t i = 0; i < n; ++i) {
+      uint8_t c = b[i];
+      if (R.ubx.empty() && c != 0xB5) {
+        if (c == '$') R.nmea = "$";
+        else if (!R.nmea.empty()) {
+          if (c == '\n') { on_nmea_cmd(R.nmea); R.nmea.clear(); }
+          else if (c != '\r') R.nmea += (char)c;
+        }
+        continue;
+      }
+      R.ubx.push_back(c);
+      if (R.ubx.size() == 2 && c != 0x62) { R.ubx.clear(); continue; }
+      if (R.ubx.size() >= 6 && R.ubx.size() == 8u + (R.ubx[4] | (R.ubx[5] << 8))) {
+        if (R.ubx[2] == 0x06 && R.ubx[3] == 0x8A) on_valset(R.ubx, t_us);
+        R.ubx.clear();
+      }
+    }
+  }
+}
+
+static void sim_ms(uint32_t t_ms) {
+  uint32_t t_us = t_ms * 1000u;
+  host_set_us(t_us);
+  rx_feed(t_us);
+  if (!O.no_rx && t_us >= R.next_us) {
+    emit_epoch(R.next_us);
+    R.next_us += R.meas_ms * 1000u;
+  }
+}
+
+static void usage() {
+  fprintf(stderr,
+          "usage: racebox_gpscfg_sim [--rx-baud N] [--rx-ubx] [--no-rx] [--nak-rate] [--no-valset-baud]\n"
+          "                          [--poll-ms N] [--expect ok|fallback|no_rx] [--expect-baud N]\n"
+          "                          [--expect-proto ubx|nmea] [--expect-pvt-ms N] [--expect-epochs N]\n"
+          "                          [--max-ms N] [-v]\n");
+}
+
+static bool parse_args(int argc, char** argv) {
+  for (int i = 1; i < argc; ++i) {
+    std::string a = argv[i];
+    auto next = [&]() -> const char* { return (i + 1 < argc) ? argv[++i] : nullptr; };
+    if (a == "--rx-ubx") O.rx_ubx = true;
+    else if (a == "--no-rx") O.no_rx = true;
+    else if (a == "--nak-rate") O.nak_rate = true;
+    else if (a == "--no-valset-baud") O.no_valset_baud = true;
+    else if (a == "-v") O.verbose = true;
+    else if (a == "--expect") { if (!(O.expect = next())) return false; }
+    else if (a == "--expect-proto") { if (!(O.expect_proto = next())) return false; }
+    else if (a == "--rx-baud" || a == "--poll-ms" || a == "--expect-baud" || a == "--expect-pvt-ms" ||
+             a == "--expect-epochs" || a == "--max-ms") {
+      const char* v = next();
+      if (!v) return false;
+      long n = atol(v);
+      if (a == "--rx-baud") O.rx_baud = (uint32_t)n;
+      else if (a == "--poll-ms") O.poll_ms = (uint32_t)std::max(1L, n);
+      else if (a == "--expect-baud") O.expect_baud = n;
+      else if (a == "--expect-pvt-ms") O.expect_pvt_ms = n;
+      else if (a == "--expect-epochs") O.expect_epochs = n;
+      else O.max_ms = n;
+    } else return false;
+  }
+  return true;
+}
+
+int main(int argc, char** argv) {
+  if (!parse_args(argc, argv)) { usage(); return 2; }
+  R.baud = O.rx_baud;
+  R.next_us = 1000 * 337;  // epoch pertama tidak sejajar dengan jendela probe
+  if (O.rx_ubx) { R.nmea_out = false; R.pvt_out = true; R.meas_ms = 50; R.dyn = 4; }
+
+  // Sama seperti init_gps(): UART dibuka di GPS_BAUD lalu auto-config
+  uint32_t t = 1;
+  host_set_us(t * 1000);
+  gps_uart_begin(115200, 27, 22);
+  gpscfg_begin({460800, 50, 4, 15000});
+  GpsCfgResult r = GCR_RUNNING;
+  for (; r == GCR_RUNNING && t < 60000; ++t) {
+    sim_ms(t);
+    if (t % O.poll_ms == 0) r = gpscfg_poll();
+  }
+  GpsCfgStatus s = gpscfg_status();
+  const char* proto = s.proto == GPS_PROTO_UBX ? "ubx" : "nmea";
+  printf("result=%s state=%s baud=%lu found=%lu proto=%s pvt_ms=%u acks=%u naks=%u retries=%u dur=%lu ms\n",
+         gpscfg_result_str(r), s.state, (unsigned long)s.baud, (unsigned long)s.found_baud, proto,
+         (unsigned)s.pvt_ms, (unsigned)s.acks, (unsigned)s.naks, (unsigned)s.retries, (unsigned long)s.dur_ms);
+  printf("receiver: baud=%lu meas=%u ms dyn=%u nmea=%d pvt=%d valsets=%lu pubx=%lu\n", (unsigned long)R.baud,
+         (unsigned)R.meas_ms, (unsigned)R.dyn, (int)R.nmea_out, (int)R.pvt_out, (unsigned long)R.valsets,
+         (unsigned long)R.pubx);
+
+  // Reader dengan protokol hasil config: epoch harus keluar pada rate receiver
+  host_log_enable(false);
+  gps_reader_begin(160, s.proto);
+  uint32_t epochs = 0;
+  for (uint32_t end = t + 2000; t < end; ++t) {
+    sim_ms(t);
+    GPSFix f;
+    while (gps_poll(f)) epochs += f.valid ? 1 : 0;
+  }
+  host_log_enable(true);
+  printf("reader: %lu valid epochs in 2 s\n", (unsigned long)epochs);
+
+  int fail = 0;
+  auto check = [&](bool ok, const char* what) { if (!ok) { printf("FAIL %s\n", what); fail++; } };
+  if (O.expect) check(!strcmp(O.expect, gpscfg_result_str(r)), "result");
+  if (O.expect_proto) check(!strcmp(O.expect_proto, proto), "proto");
+  if (O.expect_baud >= 0) check(s.baud == (uint32_t)O.expect_baud, "baud");
+  if (O.expect_pvt_ms >= 0) check(labs((long)s.pvt_ms - O.expect_pvt_ms) <= 2, "pvt_ms");
+  if (O.expect_epochs >= 0) check((long)epochs >= O.expect_epochs, "epochs");
+  if (O.max_ms >= 0) check((long)s.dur_ms <= O.max_ms, "duration");
+  if (!fail) printf("PASS\n");
+  return fail ? 1 : 0;
+}
@@ -0,0 +1,22 @@
+/*
+ * File: host/host_sim.h
+ * Description: Hooks the host build uses to drive the simulated clock, UART and log output. Generated by AI for clarity.
+ */
+#pragma once
+#include <Arduino.h>
+#include <vector>
+
+// UART simulasi: satu burst = satu panggilan callback RX di firmware
+void host_uart_push(const uint8_t* data, size_t n, uint32_t rx_us);
+void host_uart_clear();
+// Byte yang ditulis firmware ke receiver (gps_uart_write); baud aktif: gps_uart_baud()
+size_t host_uart_take_tx(uint8_t* dst, size_t n);
+
+// Log race/GPS ke stdout (false = diam, mis. saat ukur throughput)
+void host_log_enable(bool on);
+
+// FS di memori (SD): putus daya setelah N operasi tulis (-1 = tidak pernah); akses
+// isi file untuk merusak byte; kosongkan semua file
+void host_fs_cut_after(int ops);
+void host_fs_reset();
+std::vector<uint8_t>* host_fs_data(const char* path);
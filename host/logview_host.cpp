@@ -0,0 +1,26 @@
+/*
+ * File: host/logview_host.cpp
+ * Description: Host implementation of the logview API: prints log lines to stdout. Generated by AI for clarity.
+ */
+#include "../logview.h"
+#include "host_sim.h"
+
+static bool s_on = true;
+
+void host_log_enable(bool on) { s_on = on; }
+
+void logln(const String& s) {
+  if (!s_on) return;
+  fputs(s.c_str(), stdout);
+  if (!s.endsWith("\n")) fputc('\n', stdout);
+}
+
+void logf(const char* fmt, ...) {
+  if (!s_on) return;
+  char buf[256];
+  va_list ap;
+  va_start(ap, fmt);
+  vsnprintf(buf, sizeof(buf), fmt, ap);
+  va_end(ap);
+  logln(String(buf));
+}
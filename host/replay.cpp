@@ -0,0 +1,339 @@
+/*
+ * File: host/replay.cpp
+ * Description: Replays a captured NMEA/UBX byte stream through gps_read + race on the host and prints traps, ETs and stats. Generated by AI for clarity.
+ */
+/* Pemakaian:
+     racebox_replay [opsi] <capture>
+       --nmea | --ubx            paksa protokol (default: deteksi dari byte pertama)
+       --baud N                  baud untuk durasi kirim byte (default 115200)
+       --latency-us N            latency tetap receiver: epoch -> byte pertama (default 20000)
+       --jitter-us N             latency acak tambahan 0..N us per burst (uji timebase)
+       --trap NAME:AT_M[:WIN_M]  ganti daftar trap (boleh berulang)
+       --expect NAME=ET_S        exit 1 bila ET trap NAME meleset > --tol-ms
+       --expect-kph NAME=KPH     exit 1 bila trap speed meleset > --tol-kph
+       --tol-ms N                toleransi --expect (default 5)
+       --tol-kph N               toleransi --expect-kph (default 0.5)
+       --loops N                 ulang replay N kali (ukur throughput parser)
+       --check-trace             exit 1 bila waktu trap dari jejak run (race_time_at)
+                                 meleset > --tol-ms dari crossing live
+       --udp HOST:PORT           kirim paket telemetri UDP (udptel_pkt.h) per fix, seperti
+                                 firmware dengan UDPTEL_ENABLE (putaran terakhir saja)
+       --udp-pace-us N           jeda antar paket UDP (default 200; replay lebih cepat dari 20 Hz)
+       -v                        cetak setiap fix
+
+   Capture = byte mentah dari UART GPS. Waktu terima tiap burst disimulasikan dari
+   waktu GNSS di dalam data (UTC GGA/RMC atau iTOW NAV-PVT) + latency + waktu kirim
+   byte, jadi replay jalan secepat CPU tapi timing race tetap seperti di jalan. */
+#include <Arduino.h>
+#include "../gps_read.h"
+#include "../race.h"
+#include "../timebase.h"
+#include "../trace.h"
+#include "../dlog.h"
+#include "../udptel_pkt.h"
+#include "host_sim.h"
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <chrono>
+#include <vector>
+
+struct Expect { std::string name; float value; bool kph; };
+
+struct Opts {
+  int      proto = -1;          // -1 = deteksi
+  uint32_t baud = 115200;
+  uint32_t latency_us = 20000;
+  uint32_t jitter_us = 0;
+  float    tol_ms = 5.0f;
+  float    tol_kph = 0.5f;
+  int      loops = 1;
+  bool     verbose = false;
+  bool     check_trace = false;
+  const char* udp = nullptr;    // HOST:PORT
+  uint32_t udp_pace_us = 200;
+  std::vector<Trap> traps;
+  std::vector<Expect> expects;
+  const char* path = nullptr;
+};
+
+static void usage() {
+  fprintf(stderr,
+          "usage: racebox_replay [--nmea|--ubx] [--baud N] [--latency-us N] [--jitter-us N]\n"
+          "                      [--trap NAME:AT_M[:WIN_M]]... [--expect NAME=ET_S]...\n"
+          "                      [--expect-kph NAME=KPH]... [--tol-ms N] [--tol-kph N]\n"
+          "                      [--loops N] [--check-trace] [--udp HOST:PORT]\n"
+          "                      [--udp-pace-us N] [-v] <capture>\n");
+}
+
+static bool parse_args(int argc, char** argv, Opts& o) {
+  for (int i = 1; i < argc; ++i) {
+    std::string a = argv[i];
+    auto next = [&]() -> const char* { return (i + 1 < argc) ? argv[++i] : nullptr; };
+    if (a == "--nmea") o.proto = GPS_PROTO_NMEA;
+    else if (a == "--ubx") o.proto = GPS_PROTO_UBX;
+    else if (a == "-v") o.verbose = true;
+    else if (a == "--check-trace") o.check_trace = true;
+    else if (a == "--baud" || a == "--latency-us" || a == "--jitter-us" || a == "--tol-ms" ||
+             a == "--tol-kph" || a == "--loops" || a == "--udp-pace-us") {
+      const char* v = next();
+      if (!v) return false;
+      if (a == "--baud") o.baud = (uint32_t)atol(v);
+      else if (a == "--latency-us") o.latency_us = (uint32_t)atol(v);
+      else if (a == "--jitter-us") o.jitter_us = (uint32_t)atol(v);
+      else if (a == "--tol-ms") o.tol_ms = (float)atof(v);
+      else if (a == "--tol-kph") o.tol_kph = (float)atof(v);
+      else if (a == "--udp-pace-us") o.udp_pace_us = (uint32_t)atol(v);
+      else o.loops = std::max(1, atoi(v));
+    } else if (a == "--udp") {
+      if (!(o.udp = next())) return false;
+    } else if (a == "--trap") {
+      const char* v = next();
+      if (!v) return false;
+      std::string s = v;
+      size_t c1 = s.find(':');
+      if (c1 == std::string::npos) return false;
+      size_t c2 = s.find(':', c1 + 1);
+      Trap t;
+      t.name = String(s.substr(0, c1));
+      t.at_m = (float)atof(s.substr(c1 + 1, c2 - c1 - 1).c_str());
+      t.window_m = (c2 == std::string::npos) ? 0.0f : (float)atof(s.substr(c2 + 1).c_str());
+      o.traps.push_back(t);
+    } else if (a == "--expect" || a == "--expect-kph") {
+      const char* v = next();
+      if (!v) return false;
+      std::string s = v;
+      size_t eq = s.find('=');
+      if (eq == std::string::npos) return false;
+      o.expects.push_back({s.substr(0, eq), (float)atof(s.substr(eq + 1).c_str()), a == "--expect-kph"});
+    } else if (!a.empty() && a[0] == '-') return false;
+    else o.path = argv[i];
+  }
+  return o.path != nullptr;
+}
+
+// ===== Pemecah burst & pembaca waktu GNSS =====
+// NMEA: satu kalimat per burst; UBX: satu frame per burst
+struct BurstRef { size_t off, len; uint32_t gnss_ms; };
+static constexpr uint32_t NO_TIME = 0xFFFFFFFFu;
+
+static uint32_t nmea_time(const uint8_t* p, size_t n) {
+  // $xxxxx,hhmmss.sss,...
+  size_t i = 0;
+  while (i < n && p[i] != ',') i++;
+  if (++i >= n) return NO_TIME;
+  uint32_t ip = 0, fr = 0, div = 1;
+  int digits = 0;
+  bool dot = false;
+  for (; i < n && p[i] != ','; ++i) {
+    if (p[i] == '.') { dot = true; continue; }
+    if (p[i] < '0' || p[i] > '9') return NO_TIME;
+    if (dot) { if (div < 1000) { fr = fr * 10 + (p[i] - '0'); div *= 10; } }
+    else { ip = ip * 10 + (p[i] - '0'); digits++; }
+  }
+  if (digits < 6) return NO_TIME;
+  return ((ip / 10000) * 3600u + ((ip / 100) % 100) * 60u + ip % 100) * 1000u + fr * 1000u / div;
+}
+
+static std::vector<BurstRef> split_bursts(const std::vector<uint8_t>& d, bool ubx) {
+  std::vector<BurstRef> out;
+  size_t i = 0, n = d.size();
+  while (i < n) {
+    size_t len;
+    uint32_t t = NO_TIME;
+    if (ubx) {
+      if (i + 8 <= n && d[i] == 0xB5 && d[i + 1] == 0x62) {
+        size_t plen = d[i + 4] | (d[i + 5] << 8);
+        len = std::min(n - i, plen + 8);
+        // kelas NAV: payload diawali iTOW
+        if (d[i + 2] == 0x01 && plen >= 4 && i + 10 <= n)
+          t = d[i + 6] | (d[i + 7] << 8) | (d[i + 8] << 16) | ((uint32_t)d[i + 9] << 24);
+      } else {
+        len = 1;
+        while (i + len < n && !(d[i + len] == 0xB5 && i + len + 1 < n && d[i + len + 1] == 0x62)) len++;
+      }
+    } else {
+      len = 0;
+      while (i + len < n && d[i + len] != '\n') len++;
+      if (i + len < n) len++;  // ikut '\n'
+      if (d[i] == '$') t = nmea_time(&d[i], len);
+    }
+    out.push_back({i, len, t});
+    i += len;
+  }
+  return out;
+}
+
+// ===== Telemetri UDP (sama dengan udptel.cpp, dari RaceState host) =====
+static int         s_udp_fd = -1;
+static sockaddr_in s_udp_to{};
+static uint32_t    s_udp_seq = 0, s_udp_pace_us = 0;
+
+static bool udp_open(const char* spec, uint32_t pace_us) {
+  std::string s = spec;
+  size_t c = s.rfind(':');
+  if (c == std::string::npos) return false;
+  s_udp_to.sin_family = AF_INET;
+  s_udp_to.sin_port = htons((uint16_t)atoi(s.c_str() + c + 1));
+  if (inet_pton(AF_INET, s.substr(0, c).c_str(), &s_udp_to.sin_addr) != 1) return false;
+  s_udp_fd = socket(AF_INET, SOCK_DGRAM, 0);
+  int on = 1;
+  setsockopt(s_udp_fd, SOL_SOCKET, SO_BROADCAST, &on, sizeof(on));
+  s_udp_pace_us = pace_us;
+  return s_udp_fd >= 0;
+}
+
+static void udp_send(const GPSFix& fx) {
+  if (s_udp_fd < 0) return;
+  const RaceState& rs = race_state();
+  UdpTelPkt p;
+  udptel_begin_pkt(p, 0x54534F48u /* "HOST" */, ++s_udp_seq);
+  udptel_set_fix(p, fx);
+  if (rs.armed)   p.flags |= UTF_ARMED;
+  if (rs.running) p.flags |= UTF_RUNNING;
+  p.dist_mm = (rs.cum_dist_m > 0) ? (uint32_t)(rs.cum_dist_m * 1000.0f + 0.5f) : 0;
+  for (size_t i = 0; i < rs.results.size() && i < UDPTEL_MAX_TRAPS; ++i) {
+    const TrapResult& r = rs.results[i];
+    udptel_set_trap(p, (uint8_t)i, r.at_m, r.crossed, r.et_ms, r.trap_kph);
+  }
+  udptel_seal(p);
+  sendto(s_udp_fd, &p, sizeof(p), 0, (const sockaddr*)&s_udp_to, sizeof(s_udp_to));
+  if (s_udp_pace_us) usleep(s_udp_pace_us);
+}
+
+// ===== Replay =====
+static uint32_t s_rng = 12345;
+static uint32_t rnd(uint32_t n) { s_rng = s_rng * 1664525u + 1013904223u; return n ? (s_rng >> 8) % (n + 1) : 0; }
+
+static uint32_t replay_once(const Opts& o, bool ubx, const std::vector<uint8_t>& d,
+                            const std::vector<BurstRef>& bursts, uint32_t& fixes) {
+  const uint32_t period = ubx ? 604800000u : 86400000u;
+  host_uart_clear();
+  host_set_us(1000000u);
+  gps_reader_begin(160, ubx ? GPS_PROTO_UBX : GPS_PROTO_NMEA);
+  race_begin();
+  s_rng = 12345;
+
+  uint32_t cursor = 1000000u;     // akhir byte terakhir di "kabel"
+  uint32_t epoch_us = cursor;     // waktu pengukuran epoch aktif
+  uint32_t last_t = NO_TIME, last_rx = 0;
+  fixes = 0;
+  GPSFix fx;
+  for (const BurstRef& b : bursts) {
+    if (b.gnss_ms != NO_TIME && b.gnss_ms != last_t) {
+      uint32_t dg = (last_t == NO_TIME) ? 0 : (b.gnss_ms >= last_t ? b.gnss_ms - last_t : b.gnss_ms + period - last_t);
+      if (last_t == NO_TIME || dg > 5000) epoch_us = cursor;  // awal / loncatan waktu
+      else epoch_us += dg * 1000u;
+      if ((int32_t)(epoch_us + o.latency_us - cursor) > 0) cursor = epoch_us + o.latency_us;
+      last_t = b.gnss_ms;
+    }
+    cursor += (uint32_t)((uint64_t)b.len * 10u * 1000000u / o.baud);
+    uint32_t rx = cursor + rnd(o.jitter_us);
+    if ((int32_t)(rx - last_rx) < 0) rx = last_rx;
+    last_rx = rx;
+    host_set_us(rx);
+    host_uart_push(&d[b.off], b.len, rx);
+    while (gps_poll(fx)) {
+      fixes++;
+      if (fx.valid) race_update(fx);
+      udp_send(fx);
+      dlog_drain();  // idle slice firmware: event race jadi teks
+      if (o.verbose)
+        printf("fix t_us=%lu gnss=%lu valid=%d lat=%.7f lon=%.7f sog=%.2f q=%u sv=%u\n",
+               (unsigned long)fx.t_us, (unsigned long)fx.gnss_ms, (int)fx.valid,
+               gps_e7_to_deg(fx.lat_e7), gps_e7_to_deg(fx.lon_e7),
+               fx.sog_mps, (unsigned)fx.fixQ, (unsigned)fx.sv);
+    }
+  }
+  // tutup epoch terakhir lewat timeout
+  host_set_us(last_rx + 1000000u);
+  while (gps_poll(fx)) { fixes++; if (fx.valid) race_update(fx); udp_send(fx); }
+  dlog_drain();
+  return fixes;
+}
+
+int main(int argc, char** argv) {
+  Opts o;
+  if (!parse_args(argc, argv, o)) { usage(); return 2; }
+
+  FILE* f = fopen(o.path, "rb");
+  if (!f) { fprintf(stderr, "cannot open %s\n", o.path); return 2; }
+  std::vector<uint8_t> data;
+  uint8_t buf[4096];
+  size_t n;
+  while ((n = fread(buf, 1, sizeof(buf), f)) > 0) data.insert(data.end(), buf, buf + n);
+  fclose(f);
+
+  bool ubx = (o.proto >= 0) ? (o.proto == GPS_PROTO_UBX) : (!data.empty() && data[0] == 0xB5);
+  std::vector<BurstRef> bursts = split_bursts(data, ubx);
+  if (!o.traps.empty()) race_cfg().traps = o.traps;
+
+  uint32_t fixes = 0;
+  auto t0 = std::chrono::steady_clock::now();
+  for (int i = 0; i < o.loops; ++i) {
+    host_log_enable(i == o.loops - 1);  // log hanya di putaran terakhir
+    if (i == o.loops - 1 && o.udp && !udp_open(o.udp, o.udp_pace_us)) {
+      fprintf(stderr, "bad --udp %s\n", o.udp);
+      return 2;
+    }
+    replay_once(o, ubx, data, bursts, fixes);
+  }
+  double wall = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+  if (s_udp_fd >= 0) { printf("UDP: %lu packets -> %s\n", (unsigned long)s_udp_seq, o.udp); close(s_udp_fd); }
+
+  // ===== Ringkasan =====
+  const RaceState& rs = race_state();
+  printf("\n== %s: %zu bytes, %zu bursts, %s ==\n", o.path, data.size(), bursts.size(), ubx ? "UBX" : "NMEA");
+  printf("%-8s %9s %10s %10s\n", "trap", "at_m", "ET_s", "trap_kph");
+  for (const TrapResult& r : rs.results) {
+    if (r.crossed) printf("%-8s %9.3f %10.4f %10.2f\n", r.name.c_str(), r.at_m, r.et_ms / 1000.0f, r.trap_kph);
+    else           printf("%-8s %9.3f %10s %10s\n", r.name.c_str(), r.at_m, "-", "-");
+  }
+
+  const GPSStats& s = gps_stats();
+  printf("\nGPSStats: fixes=%lu epochs=%lu partial=%lu nmea_lines=%lu gga_ok=%lu rmc_ok=%lu cks_fail=%lu\n"
+         "          ubx_pvt_ok=%lu ubx_cks_fail=%lu ubx_bad_len=%lu reject_hdop=%lu reject_acc=%lu\n"
+         "          reject_jump=%lu\n",
+         (unsigned long)fixes, (unsigned long)s.epochs, (unsigned long)s.epoch_partial,
+         (unsigned long)s.nmea_lines, (unsigned long)s.gga_ok, (unsigned long)s.rmc_ok,
+         (unsigned long)s.cks_fail, (unsigned long)s.ubx_pvt_ok, (unsigned long)s.ubx_cks_fail,
+         (unsigned long)s.ubx_bad_len, (unsigned long)s.reject_hdop, (unsigned long)s.reject_acc,
+         (unsigned long)s.reject_jump);
+  const TimebaseStats& tb = timebase_stats();
+  printf("Timebase: obs=%lu resets=%lu locked=%d skew=%.2f ppm last_jitter=%ld us\n",
+         (unsigned long)tb.obs, (unsigned long)tb.resets, (int)tb.locked, tb.skew_ppm, (long)tb.jitter_us);
+  uint32_t sentences = ubx ? s.ubx_pvt_ok : s.nmea_lines;
+  double total_b = (double)data.size() * o.loops;
+  printf("Throughput: %d loop(s) in %.3f s, %.1f MB/s, %.0f sentences/s\n", o.loops, wall,
+         total_b / wall / 1e6, (double)sentences * o.loops / wall);
+
+  // ===== Cek ekspektasi =====
+  int fail = 0;
+  for (const Expect& e : o.expects) {
+    const TrapResult* r = nullptr;
+    for (const TrapResult& x : rs.results) if (e.name == x.name.c_str()) r = &x;
+    if (!r || !r->crossed) { printf("FAIL %s: not crossed\n", e.name.c_str()); fail++; continue; }
+    float got = e.kph ? r->trap_kph : r->et_ms / 1000.0f;
+    float err = e.kph ? fabsf(got - e.value) : fabsf(got - e.value) * 1000.0f;
+    float tol = e.kph ? o.tol_kph : o.tol_ms;
+    printf("%s %s %s: got %.4f expect %.4f (err %.3f %s)\n", err <= tol ? "PASS" : "FAIL",
+           e.name.c_str(), e.kph ? "kph" : "ET", got, e.value, err, e.kph ? "kph" : "ms");
+    if (err > tol) fail++;
+  }
+  if (o.check_trace) {
+    // jejak run penuh harus tetap menjawab crossing walau sudah di-decimate
+    const TraceStats ts = trace_stats();
+    printf("Trace: samples=%lu bytes=%lu blocks=%u stride=%u decimations=%u\n", (unsigned long)ts.samples,
+           (unsigned long)ts.bytes, (unsigned)ts.blocks, (unsigned)ts.stride, (unsigned)ts.decimations);
+    for (const TrapResult& r : rs.results) {
+      if (!r.crossed) continue;
+      uint32_t t = 0;
+      bool ok = race_time_at(r.at_m, t);
+      float err = ok ? fabsf((float)(int32_t)(t - r.t_cross_us)) / 1000.0f : 1e9f;
+      printf("%s trace %s: err %.3f ms\n", err <= o.tol_ms ? "PASS" : "FAIL", r.name.c_str(), ok ? err : -1.0f);
+      if (err > o.tol_ms) fail++;
+    }
+  }
+  return fail ? 1 : 0;
+}
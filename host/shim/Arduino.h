@@ -0,0 +1,71 @@
+/*
+ * File: host/shim/Arduino.h
+ * Description: Thin Arduino shim for building gps_read/race on a Linux host with a simulated clock. Generated by AI for clarity.
+ */
+#pragma once
+/* Hanya yang dipakai modul GPS/race: tipe, String, millis/micros, constrain/min/max.
+   Waktu = clock simulasi (host_set_us), bukan jam dinding, jadi replay bisa
+   berjalan jauh lebih cepat dari real time dan hasilnya deterministik. */
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdarg.h>
+#include <math.h>
+#include <algorithm>
+#include <string>
+
+using std::max;
+using std::min;
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+#define constrain(amt, low, high) ((amt) < (low) ? (low) : ((amt) > (high) ? (high) : (amt)))
+#define F(s) (s)
+
+// ===== Clock simulasi =====
+void     host_set_us(uint32_t us);   // set waktu (micros) sekarang
+uint32_t micros();
+uint32_t millis();
+void     delay(uint32_t ms);         // memajukan clock simulasi
+
+size_t strlcpy(char* dst, const char* src, size_t size);
+
+// ===== String (subset Arduino, di atas std::string) =====
+class String {
+public:
+  String() {}
+  String(const char* s) : s_(s ? s : "") {}
+  String(const std::string& s) : s_(s) {}
+  String(int v) : s_(std::to_string(v)) {}
+  String(unsigned v) : s_(std::to_string(v)) {}
+  String(long v) : s_(std::to_string(v)) {}
+  String(unsigned long v) : s_(std::to_string(v)) {}
+  String(float v, int dec = 2) { char b[32]; snprintf(b, sizeof(b), "%.*f", dec, v); s_ = b; }
+  String(double v, int dec = 2) { char b[32]; snprintf(b, sizeof(b), "%.*f", dec, v); s_ = b; }
+
+  const char* c_str() const { return s_.c_str(); }
+  size_t length() const { return s_.size(); }
+  bool isEmpty() const { return s_.empty(); }
+  bool endsWith(const String& o) const {
+    return s_.size() >= o.s_.size() && s_.compare(s_.size() - o.s_.size(), o.s_.size(), o.s_) == 0;
+  }
+  bool startsWith(const String& o) const { return s_.compare(0, o.s_.size(), o.s_) == 0; }
+  void remove(size_t i, size_t n) { s_.erase(i, n); }
+  void reserve(size_t n) { s_.reserve(n); }
+  int toInt() const { return atoi(s_.c_str()); }
+  float toFloat() const { return (float)atof(s_.c_str()); }
+  char operator[](size_t i) const { return s_[i]; }
+
+  String& operator+=(const String& o) { s_ += o.s_; return *this; }
+  String& operator+=(const char* o) { s_ += o; return *this; }
+  String& operator+=(char c) { s_ += c; return *this; }
+  friend String operator+(const String& a, const String& b) { return String(a.s_ + b.s_); }
+  bool operator==(const String& o) const { return s_ == o.s_; }
+  bool operator!=(const String& o) const { return s_ != o.s_; }
+
+private:
+  std::string s_;
+};
@@ -0,0 +1,47 @@
+/*
+ * File: host/shim/FS.h
+ * Description: Host stand-in for the Arduino FS/File API: an in-memory filesystem (empty at start, so config falls back to defaults) with power-cut injection. Generated by AI for clarity.
+ */
+#pragma once
+/* File disimpan di map path -> byte (host/arduino_shim.cpp). Operasi yang mengubah isi
+   (write, remove, rename, open FILE_WRITE) bisa "diputus" lewat host_fs_cut_after()
+   di host_sim.h untuk menguji urutan tulis atomik cfgstore. */
+#include <Arduino.h>
+#include <memory>
+#include <vector>
+
+#define FILE_READ   "r"
+#define FILE_WRITE  "w"
+#define FILE_APPEND "a"
+
+namespace fs {
+class File {
+public:
+  File() {}
+  File(std::shared_ptr<std::vector<uint8_t>> d, bool wr) : d_(d), wr_(wr) {}
+  explicit operator bool() const { return d_ != nullptr; }
+  size_t size() const { return d_ ? d_->size() : 0; }
+  int available() { return d_ ? (int)(d_->size() - pos_) : 0; }
+  int read() { return (d_ && pos_ < d_->size()) ? (*d_)[pos_++] : -1; }
+  size_t read(uint8_t* buf, size_t n);
+  size_t write(uint8_t c) { return write(&c, 1); }
+  size_t write(const uint8_t* buf, size_t n);
+  void flush() {}
+  void close() { d_.reset(); }
+
+private:
+  std::shared_ptr<std::vector<uint8_t>> d_;
+  size_t pos_ = 0;
+  bool wr_ = false;
+};
+
+class FS {
+public:
+  bool exists(const char* path);
+  File open(const char* path, const char* mode = FILE_READ, bool create = false);
+  bool mkdir(const char*) { return true; }
+  bool remove(const char* path);
+  bool rename(const char* from, const char* to);
+};
+}  // namespace fs
+using fs::File;
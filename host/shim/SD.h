@@ -0,0 +1,8 @@
+/*
+ * File: host/shim/SD.h
+ * Description: Host stand-in for the SD card filesystem. Generated by AI for clarity.
+ */
+#pragma once
+#include <FS.h>
+
+extern fs::FS SD;
@@ -0,0 +1,7 @@
+/*
+ * File: host/shim/lvgl.h
+ * Description: Minimal LVGL types needed by logview.h on the host build. Generated by AI for clarity.
+ */
+#pragma once
+#include <stdint.h>
+typedef int8_t lv_log_level_t;
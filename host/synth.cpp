@@ -0,0 +1,121 @@
+/*
+ * File: host/synth.cpp
+ * Description: Generates a synthetic drag-run capture (NMEA GGA/RMC or UBX NAV-PVT) with known trap times. Generated by AI for clarity.
+ */
+/* Pemakaian:
+     racebox_synth [--ubx] [--rate HZ] [--hold S] [--speed MPS] [--dur S] <out>
+   Diam selama --hold detik lalu langsung melaju konstan --speed m/s ke utara.
+   Karena kecepatan konstan setelah start, ET ke trap X = X / speed berapapun fix
+   yang memicu start, sehingga hasil replay bisa dicek eksak (lihat CMakeLists). */
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <vector>
+
+// Radius meridian WGS84 di lintang lat (m); sama dengan skala frame ENU race (geo.cpp)
+static double meridian_radius(double lat_deg) {
+  const double a = 6378137.0, e2 = 6.69437999014e-3;
+  double s = sin(lat_deg * M_PI / 180.0), w = 1.0 - e2 * s * s;
+  return a * (1.0 - e2) / (w * sqrt(w));
+}
+
+static void nmea_emit(FILE* f, const char* body) {
+  uint8_t x = 0;
+  for (const char* p = body; *p; ++p) x ^= (uint8_t)*p;
+  fprintf(f, "$%s*%02X\r\n", body, x);
+}
+
+// deg -> "ddmm.mmmmm" / "dddmm.mmmmm"
+static std::string dm(double deg, int deg_digits) {
+  deg = fabs(deg);
+  int d = (int)deg;
+  double m = (deg - d) * 60.0;
+  char b[32];
+  snprintf(b, sizeof(b), "%0*d%08.5f", deg_digits, d, m);
+  return b;
+}
+
+static void put_u2(std::vector<uint8_t>& p, size_t o, uint32_t v) { p[o] = v & 0xFF; p[o + 1] = (v >> 8) & 0xFF; }
+static void put_u4(std::vector<uint8_t>& p, size_t o, uint32_t v) {
+  for (int i = 0; i < 4; ++i) p[o + i] = (v >> (8 * i)) & 0xFF;
+}
+
+static void ubx_emit_pvt(FILE* f, uint32_t itow, double lat, double lon, double sog, double cog) {
+  std::vector<uint8_t> p(92, 0);
+  put_u4(p, 0, itow);
+  p[20] = 3;     // fixType 3D
+  p[21] = 0x01;  // gnssFixOK
+  p[23] = 14;    // numSV
+  put_u4(p, 24, (uint32_t)(int32_t)llround(lon * 1e7));
+  put_u4(p, 28, (uint32_t)(int32_t)llround(lat * 1e7));
+  put_u4(p, 36, 100000);                       // hMSL 100 m
+  put_u4(p, 40, 500);                          // hAcc 0.5 m
+  put_u4(p, 60, (uint32_t)llround(sog * 1000)); // gSpeed mm/s
+  put_u4(p, 64, (uint32_t)(int32_t)llround(cog * 1e5));
+  put_u4(p, 68, 200);                          // sAcc 0.2 m/s
+  put_u2(p, 76, 120);                          // pDOP 1.2
+  std::vector<uint8_t> fr = {0xB5, 0x62, 0x01, 0x07, 92, 0};
+  fr.insert(fr.end(), p.begin(), p.end());
+  uint8_t a = 0, b = 0;
+  for (size_t i = 2; i < fr.size(); ++i) { a += fr[i]; b += a; }
+  fr.push_back(a);
+  fr.push_back(b);
+  fwrite(fr.data(), 1, fr.size(), f);
+}
+
+int main(int argc, char** argv) {
+  bool ubx = false;
+  double rate = 10, hold = 3, speed = 20, dur = 25;
+  const char* out = nullptr;
+  for (int i = 1; i < argc; ++i) {
+    std::string a = argv[i];
+    if (a == "--ubx") ubx = true;
+    else if ((a == "--rate" || a == "--hold" || a == "--speed" || a == "--dur") && i + 1 < argc) {
+      double v = atof(argv[++i]);
+      if (a == "--rate") rate = v; else if (a == "--hold") hold = v;
+      else if (a == "--speed") speed = v; else dur = v;
+    } else out = argv[i];
+  }
+  if (!out || rate <= 0) {
+    fprintf(stderr, "usage: racebox_synth [--ubx] [--rate HZ] [--hold S] [--speed MPS] [--dur S] <out>\n");
+    return 2;
+  }
+  FILE* f = fopen(out, "wb");
+  if (!f) { fprintf(stderr, "cannot write %s\n", out); return 2; }
+
+  const double lat0 = -7.2575, lon0 = 112.7521;  // arah utara: jarak = M(lat0) * dlat
+  const double R_N = meridian_radius(lat0);
+  const uint32_t t0_ms = 10 * 3600000u;           // 10:00:00 UTC / iTOW
+  const uint32_t step_ms = (uint32_t)llround(1000.0 / rate);
+  const uint32_t n = (uint32_t)((hold + dur) * rate);
+
+  for (uint32_t k = 0; k <= n; ++k) {
+    uint32_t t_ms = k * step_ms;
+    double t = t_ms / 1000.0;
+    double x = (t > hold) ? (t - hold) * speed : 0.0;
+    double v = (t > hold) ? speed : 0.0;
+    double lat = lat0 + (x / R_N) * 180.0 / M_PI;
+    double lon = lon0;
+    uint32_t tod = t0_ms + t_ms;
+
+    if (ubx) { ubx_emit_pvt(f, tod, lat, lon, v, 0.0); continue; }
+
+    char hms[16];
+    snprintf(hms, sizeof(hms), "%02u%02u%02u.%02u", tod / 3600000u, (tod / 60000u) % 60u,
+             (tod / 1000u) % 60u, (tod % 1000u) / 10u);
+    std::string la = dm(lat, 2), lo = dm(lon, 3);
+    char ns = lat < 0 ? 'S' : 'N', ew = lon < 0 ? 'W' : 'E';
+    char body[160];
+    snprintf(body, sizeof(body), "GNGGA,%s,%s,%c,%s,%c,1,14,0.8,100.0,M,0.0,M,,", hms, la.c_str(), ns,
+             lo.c_str(), ew);
+    nmea_emit(f, body);
+    snprintf(body, sizeof(body), "GNRMC,%s,A,%s,%c,%s,%c,%.3f,0.0,170826,,,A", hms, la.c_str(), ns,
+             lo.c_str(), ew, v / 0.514444);
+    nmea_emit(f, body);
+  }
+  fclose(f);
+  return 0;
+}
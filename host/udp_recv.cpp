@@ -0,0 +1,223 @@
+/*
+ * File: host/udp_recv.cpp
+ * Description: Host-side listener/decoder for the binary UDP telemetry stream (udptel_pkt.h) with loss, CRC and trap checks. Generated by AI for clarity.
+ */
+/* Pemakaian:
+     racebox_udp_recv [opsi] [-- CMD ARG...]
+       --port N               port UDP (default 5005; 0 = ephemeral, hanya berguna dengan CMD)
+       --group A.B.C.D        join grup multicast (UDPTEL_MULTICAST=true di firmware)
+       --count N              berhenti setelah N paket valid
+       --timeout-ms N         berhenti bila tidak ada paket selama N ms (default 0 = tunggu terus;
+                              dengan CMD default 500 setelah CMD selesai)
+       --expect I=ET_S        exit 1 bila ET trap indeks I (paket terakhir) meleset > --tol-ms
+       --expect-kph I=KPH     exit 1 bila trap speed indeks I meleset > --tol-kph
+       --tol-ms N / --tol-kph N   toleransi (default 1 / 0.5; paket membawa ET dalam us)
+       --max-loss N           exit 1 bila total gap seq > N
+       -v                     cetak setiap paket
+     CMD dijalankan setelah socket terikat; "{port}" di argumennya diganti port aktual.
+     Contoh uji loopback:
+       racebox_udp_recv --port 0 --max-loss 0 --expect 4=20.1168 -- \
+         racebox_replay --udp 127.0.0.1:{port} drag_ubx.ubx
+
+   Listener mencatat per device_id (beberapa mobil di satu jaringan): jumlah paket,
+   gap seq (paket hilang), paket rusak (ukuran/magic/CRC), dan hasil trap terakhir. */
+#include "../udptel_pkt.h"
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <map>
+#include <string>
+#include <vector>
+
+struct Expect { int idx; float value; bool kph; };
+
+struct Opts {
+  int      port = 5005;
+  const char* group = nullptr;
+  uint32_t count = 0;
+  int      timeout_ms = -1;
+  float    tol_ms = 1.0f;
+  float    tol_kph = 0.5f;
+  long     max_loss = -1;
+  bool     verbose = false;
+  std::vector<Expect> expects;
+  std::vector<std::string> cmd;
+};
+
+struct Device {
+  uint32_t packets = 0, lost = 0, reordered = 0;
+  uint32_t last_seq = 0;
+  UdpTelPkt last{};
+};
+
+static void usage() {
+  fprintf(stderr,
+          "usage: racebox_udp_recv [--port N] [--group A.B.C.D] [--count N] [--timeout-ms N]\n"
+          "                        [--expect I=ET_S]... [--expect-kph I=KPH]... [--tol-ms N]\n"
+          "                        [--tol-kph N] [--max-loss N] [-v] [-- CMD ARG...]\n");
+}
+
+static bool parse_args(int argc, char** argv, Opts& o) {
+  for (int i = 1; i < argc; ++i) {
+    std::string a = argv[i];
+    auto next = [&]() -> const char* { return (i + 1 < argc) ? argv[++i] : nullptr; };
+    if (a == "--") {
+      for (++i; i < argc; ++i) o.cmd.push_back(argv[i]);
+      return !o.cmd.empty();
+    } else if (a == "-v") o.verbose = true;
+    else if (a == "--group") { if (!(o.group = next())) return false; }
+    else if (a == "--port" || a == "--count" || a == "--timeout-ms" || a == "--tol-ms" ||
+             a == "--tol-kph" || a == "--max-loss") {
+      const char* v = next();
+      if (!v) return false;
+      if (a == "--port") o.port = atoi(v);
+      else if (a == "--count") o.count = (uint32_t)atol(v);
+      else if (a == "--timeout-ms") o.timeout_ms = atoi(v);
+      else if (a == "--tol-ms") o.tol_ms = (float)atof(v);
+      else if (a == "--tol-kph") o.tol_kph = (float)atof(v);
+      else o.max_loss = atol(v);
+    } else if (a == "--expect" || a == "--expect-kph") {
+      const char* v = next();
+      if (!v) return false;
+      std::string s = v;
+      size_t eq = s.find('=');
+      if (eq == std::string::npos) return false;
+      o.expects.push_back({atoi(s.substr(0, eq).c_str()), (float)atof(s.substr(eq + 1).c_str()), a == "--expect-kph"});
+    } else return false;
+  }
+  return true;
+}
+
+static void print_pkt(const UdpTelPkt& p) {
+  char hacc[16] = "-";
+  if (p.hacc_cm != 0xFFFF) snprintf(hacc, sizeof(hacc), "%.2f", p.hacc_cm / 100.0);
+  printf("dev=%08lx seq=%lu gnss=%lu lat=%.7f lon=%.7f alt=%.2f kph=%.2f cog=%.2f hacc=%s q=%u sv=%u "
+         "st=%c%c%c d=%.3f",
+         (unsigned long)p.device_id, (unsigned long)p.seq, (unsigned long)p.gnss_ms, p.lat_e7 * 1e-7,
+         p.lon_e7 * 1e-7, p.alt_cm / 100.0, p.sog_cms * 0.036, p.cog_cdeg / 100.0,
+         hacc, (unsigned)p.fixQ, (unsigned)p.sv,
+         (p.flags & UTF_VALID) ? 'V' : '-', (p.flags & UTF_ARMED) ? 'A' : '-', (p.flags & UTF_RUNNING) ? 'R' : '-',
+         p.dist_mm / 1000.0);
+  for (uint8_t i = 0; i < p.n_traps && i < UDPTEL_MAX_TRAPS; ++i)
+    if (p.crossed_mask & (1u << i))
+      printf(" [%u@%.1f %.4fs %.2fkph]", (unsigned)i, p.trap[i].at_dm / 10.0, p.trap[i].et_us / 1e6,
+             p.trap[i].kph_c / 100.0);
+  printf("\n");
+}
+
+int main(int argc, char** argv) {
+  Opts o;
+  if (!parse_args(argc, argv, o)) { usage(); return 2; }
+  if (o.timeout_ms < 0) o.timeout_ms = o.cmd.empty() ? 0 : 500;
+
+  int fd = socket(AF_INET, SOCK_DGRAM, 0);
+  int on = 1, rcvbuf = 1 << 20;
+  setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &on, sizeof(on));
+  setsockopt(fd, SOL_SOCKET, SO_RCVBUF, &rcvbuf, sizeof(rcvbuf));
+  sockaddr_in a{};
+  a.sin_family = AF_INET;
+  a.sin_port = htons((uint16_t)o.port);
+  a.sin_addr.s_addr = htonl(INADDR_ANY);
+  if (bind(fd, (sockaddr*)&a, sizeof(a)) != 0) { perror("bind"); return 2; }
+  socklen_t al = sizeof(a);
+  getsockname(fd, (sockaddr*)&a, &al);
+  int port = ntohs(a.sin_port);
+  if (o.group) {
+    ip_mreq m{};
+    if (inet_pton(AF_INET, o.group, &m.imr_multiaddr) != 1) { fprintf(stderr, "bad --group\n"); return 2; }
+    m.imr_interface.s_addr = htonl(INADDR_ANY);
+    if (setsockopt(fd, IPPROTO_IP, IP_ADD_MEMBERSHIP, &m, sizeof(m)) != 0) { perror("IP_ADD_MEMBERSHIP"); return 2; }
+  }
+  fprintf(stderr, "listening on udp :%d%s%s\n", port, o.group ? " group " : "", o.group ? o.group : "");
+
+  // pengirim dijalankan setelah socket siap: tidak ada paket awal yang terlewat
+  pid_t child = -1;
+  if (!o.cmd.empty()) {
+    std::vector<std::string> args = o.cmd;
+    for (std::string& s : args)
+      for (size_t k; (k = s.find("{port}")) != std::string::npos;) s.replace(k, 6, std::to_string(port));
+    fflush(stdout);
+    child = fork();
+    if (child == 0) {
+      std::vector<char*> av;
+      for (std::string& s : args) av.push_back(&s[0]);
+      av.push_back(nullptr);
+      dup2(2, 1);  // keluaran pengirim ke stderr, stdout milik decoder
+      execvp(av[0], av.data());
+      perror("execvp");
+      _exit(127);
+    }
+  }
+
+  std::map<uint32_t, Device> devs;
+  uint32_t valid = 0, bad = 0;
+  int child_status = 0;
+  bool child_done = (child < 0);
+  uint8_t buf[1500];
+  for (;;) {
+    if (o.count && valid >= o.count) break;
+    if (!child_done && waitpid(child, &child_status, WNOHANG) == child) child_done = true;
+    // CMD masih jalan: tunggu terus (cek waitpid tiap 50 ms); sesudahnya pakai timeout
+    int wait_ms = !child_done ? 50 : (o.timeout_ms > 0 ? o.timeout_ms : -1);
+    pollfd pf{fd, POLLIN, 0};
+    int r = poll(&pf, 1, wait_ms);
+    if (r < 0) { perror("poll"); break; }
+    if (r == 0) { if (child_done) break; continue; }
+    ssize_t n = recv(fd, buf, sizeof(buf), 0);
+    if (n < 0) continue;
+    UdpTelPkt p;
+    if (!udptel_check(buf, (size_t)n, p)) { bad++; continue; }
+    valid++;
+    Device& d = devs[p.device_id];
+    if (d.packets && p.seq != d.last_seq + 1) {
+      if ((int32_t)(p.seq - d.last_seq) > 0) d.lost += p.seq - d.last_seq - 1;
+      else { d.reordered++; continue; }  // paket basi: jangan timpa state terbaru
+    }
+    d.packets++;
+    d.last_seq = p.seq;
+    d.last = p;
+    if (o.verbose) print_pkt(p);
+  }
+  if (!child_done) waitpid(child, &child_status, 0);
+
+  // ===== Ringkasan =====
+  printf("\n== UDP telemetry :%d: %lu valid, %lu bad ==\n", port, (unsigned long)valid, (unsigned long)bad);
+  uint32_t lost = 0;
+  for (auto& kv : devs) {
+    const Device& d = kv.second;
+    lost += d.lost;
+    printf("device %08lx: packets=%lu lost=%lu reordered=%lu last_seq=%lu\n", (unsigned long)kv.first,
+           (unsigned long)d.packets, (unsigned long)d.lost, (unsigned long)d.reordered, (unsigned long)d.last_seq);
+    printf("  last: ");
+    print_pkt(d.last);
+  }
+
+  int fail = 0;
+  if (bad) { printf("FAIL %lu bad packet(s)\n", (unsigned long)bad); fail++; }
+  if (o.max_loss >= 0 && (long)lost > o.max_loss) { printf("FAIL lost %lu > %ld\n", (unsigned long)lost, o.max_loss); fail++; }
+  if (child >= 0 && !(WIFEXITED(child_status) && WEXITSTATUS(child_status) == 0)) {
+    printf("FAIL sender exit status %d\n", WIFEXITED(child_status) ? WEXITSTATUS(child_status) : -1);
+    fail++;
+  }
+  // ekspektasi dicek pada paket terakhir device pertama (uji loopback: satu pengirim)
+  const UdpTelPkt* last = devs.empty() ? nullptr : &devs.begin()->second.last;
+  for (const Expect& e : o.expects) {
+    if (!last || e.idx < 0 || e.idx >= UDPTEL_MAX_TRAPS || !(last->crossed_mask & (1u << e.idx))) {
+      printf("FAIL trap %d: not crossed\n", e.idx); fail++; continue;
+    }
+    const UdpTelTrap& t = last->trap[e.idx];
+    float got = e.kph ? t.kph_c / 100.0f : t.et_us / 1e6f;
+    float err = e.kph ? fabsf(got - e.value) : fabsf(got - e.value) * 1000.0f;
+    float tol = e.kph ? o.tol_kph : o.tol_ms;
+    printf("%s trap %d %s: got %.4f expect %.4f (err %.3f %s)\n", err <= tol ? "PASS" : "FAIL", e.idx,
+           e.kph ? "kph" : "ET", got, e.value, err, e.kph ? "kph" : "ms");
+    if (err > tol) fail++;
+  }
+  close(fd);
+  return fail ? 1 : 0;
+}
@@ -0,0 +1,107 @@
+/*
+ * File: httpout.cpp
+ * Description: Implements the fixed-buffer HTTP writer and streaming JSON emitter. Generated by AI for clarity.
+ */
+#include "httpout.h"
+#include "pipeline.h"
+#include <stdarg.h>
+#include <math.h>
+
+static constexpr size_t OUT_BYTES = 1436;  // ~1 segmen TCP
+static WebServer*  s_srv = nullptr;
+static const char* s_type = "text/plain";
+static char   s_buf[OUT_BYTES];
+static size_t s_n = 0;
+static bool   s_chunked = false;           // header sudah terkirim (mode chunked)
+
+static void flush(){
+  if (!s_chunked){
+    s_srv->setContentLength(CONTENT_LENGTH_UNKNOWN);
+    s_srv->send(200, s_type, "");
+    s_chunked = true;
+  }
+  if (s_n){ s_srv->sendContent(s_buf, s_n); s_n = 0; }
+  pipeline_poll();  // mode single loop: fix tetap diproses selama respons panjang
+}
+
+void http_out_begin(WebServer& srv, const char* type, const char* filename){
+  s_srv = &srv; s_type = type; s_n = 0; s_chunked = false;
+  if (filename) srv.sendHeader("Content-Disposition", String("attachment; filename=") + filename);
+}
+
+void http_out_write(const char* s, size_t n){
+  while (n){
+    if (s_n == OUT_BYTES) flush();
+    size_t k = min(n, OUT_BYTES - s_n);
+    memcpy(s_buf + s_n, s, k);
+    s_n += k; s += k; n -= k;
+  }
+}
+
+void http_out_printf(const char* fmt, ...){
+  char line[256];
+  va_list ap; va_start(ap, fmt);
+  int k = vsnprintf(line, sizeof(line), fmt, ap);
+  va_end(ap);
+  if (k > 0) http_out_write(line, min((size_t)k, sizeof(line) - 1));
+}
+
+void http_out_end(){
+  if (s_chunked){
+    flush();
+    s_srv->sendContent("");  // chunk terakhir (panjang 0)
+    return;
+  }
+  // muat satu buffer: kirim dengan Content-Length, tanpa chunk
+  s_srv->setContentLength(s_n);
+  s_srv->send(200, s_type, "");
+  if (s_n) s_srv->sendContent(s_buf, s_n);
+  s_n = 0;
+}
+
+// ===== JsonOut =====
+void JsonOut::item(const char* key){
+  if (!first_) http_out_write(",", 1);
+  if (pretty_ && depth_){
+    http_out_write("\r\n", 2);
+    for (uint8_t i = 0; i < depth_; ++i) http_out_write("  ", 2);
+  }
+  if (key){
+    str(key);
+    if (pretty_) http_out_write(": ", 2); else http_out_write(":", 1);
+  }
+  first_ = false;
+}
+
+void JsonOut::close(char c){
+  if (depth_) depth_--;
+  if (pretty_ && !first_){
+    http_out_write("\r\n", 2);
+    for (uint8_t i = 0; i < depth_; ++i) http_out_write("  ", 2);
+  }
+  http_out_write(&c, 1);
+  first_ = false;
+}
+
+void JsonOut::obj(const char* key){ item(key); http_out_write("{", 1); depth_++; first_ = true; }
+void JsonOut::arr(const char* key){ item(key); http_out_write("[", 1); depth_++; first_ = true; }
+
+void JsonOut::str(const char* s){
+  http_out_write("\"", 1);
+  for (; *s; ++s){
+    char c = *s;
+    if (c == '"' || c == '\\'){ char e[2] = {'\\', c}; http_out_write(e, 2); }
+    else if ((uint8_t)c < 0x20) http_out_printf("\\u%04x", (unsigned)(uint8_t)c);
+    else http_out_write(&c, 1);
+  }
+  http_out_write("\"", 1);
+}
+
+void JsonOut::kv(const char* key, const char* v){ item(key); str(v); }
+void JsonOut::kv(const char* key, uint32_t v){ item(key); http_out_printf("%lu", (unsigned long)v); }
+void JsonOut::kv(const char* key, bool v){ item(key); http_out_write(v ? "true" : "false", v ? 4 : 5); }
+void JsonOut::kv(const char* key, float v){
+  item(key);
+  if (isfinite(v)) http_out_printf("%.7g", (double)v);
+  else http_out_write("null", 4);
+}
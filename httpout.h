@@ -0,0 +1,39 @@
+/*
+ * File: httpout.h
+ * Description: Fixed-buffer HTTP response writer (Content-Length or chunked) and a minimal streaming JSON emitter on top of it. Generated by AI for clarity.
+ */
+#pragma once
+/* Respons HTTP tanpa String/JsonDocument perantara.
+   - Teks ditulis ke satu buffer statis ~1 segmen TCP. Header baru dikirim saat buffer
+     pertama kali penuh (lalu chunked) atau di http_out_end() (Content-Length pasti):
+     respons kecil = satu write, tanpa overhead chunk.
+   - Di sela flush pipeline_poll() dipanggil supaya fix tetap diproses (mode single loop).
+   - WebServer sinkron: hanya satu respons aktif pada satu waktu. */
+#include <Arduino.h>
+#include <WebServer.h>
+
+void http_out_begin(WebServer& srv, const char* type, const char* filename = nullptr);
+void http_out_write(const char* s, size_t n);
+void http_out_printf(const char* fmt, ...) __attribute__((format(printf, 1, 2)));
+void http_out_end();
+
+// JSON streaming: pretty (indent 2, seperti serializeJsonPretty) atau compact
+struct JsonOut {
+  explicit JsonOut(bool pretty) : pretty_(pretty) {}
+  void obj(const char* key = nullptr);    // buka objek (key bila di dalam objek)
+  void arr(const char* key = nullptr);
+  void end_obj() { close('}'); }
+  void end_arr() { close(']'); }
+  void kv(const char* key, const char* v);
+  void kv(const char* key, float v);
+  void kv(const char* key, uint32_t v);
+  void kv(const char* key, bool v);
+
+private:
+  void item(const char* key);   // koma + indent + "key":
+  void close(char c);
+  void str(const char* s);
+  bool    pretty_;
+  uint8_t depth_ = 0;
+  bool    first_ = true;        // belum ada item di container aktif
+};
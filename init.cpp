@@ -5,7 +5,20 @@
 #include "init.h"
 #include "logview.h"
 #include "gps_read.h"
+#include "gps_uart.h"
+#include "gpscfg.h"
 #include "race.h"
+#include "pipeline.h"
+#include "runlog.h"
+#include "runexport.h"
+#include "httpout.h"
+#include "live.h"
+#include "udptel.h"
+#include "dlog.h"
+#include "perf.h"
+#include "sched.h"
+#include "cfgstore.h"
+#include <uri/UriBraces.h>
 #include <ArduinoJson.h> // untuk serialisasi/deserialisasi konfigurasi
 
 // ====== DMA flush state ======
@@ -59,11 +72,6 @@ static void touchscreen_read_cb(lv_indev_t* indev, lv_indev_data_t* data) {
 }
 
 // ====== Helpers ======
-static void ui_yield_step() {
-  poll_dma_complete();
-  lv_timer_handler();
-}
-
 static bool init_sdcard() {
   // HSPI untuk hindari konflik dengan TFT (VSPI)
   sdSPI.begin(SD_SCK, SD_MISO, SD_MOSI, SD_CS);
@@ -86,70 +94,101 @@ static bool init_sdcard() {
   return true;
 }
 
-static bool init_wifi(uint32_t timeout_ms = 5000) {
-  WiFi.mode(WIFI_STA);
-  WiFi.begin(WIFI_SSID, WIFI_PASS);
-  logf("[WiFi] Connecting to %s ...", WIFI_SSID);
-
-  uint32_t start = millis();
-  wl_status_t st;
-  do {
-    ui_yield_step();
-    st = WiFi.status();
-    if (st == WL_CONNECTED) break;
-  } while (millis() - start < timeout_ms);
-
-  if (st == WL_CONNECTED) {
-    logf("[WiFi] OK: %s", WiFi.localIP().toString().c_str());
-    return true;
-  } else {
-    logln("[WiFi] FAILED");
-    return false;
-  }
-}
+static bool s_gps_up = false;   // reader + pipeline jalan (setelah auto-config receiver)
 
 static bool init_gps() {
-  GPSSerial.begin(GPS_BAUD, SERIAL_8N1, GPS_RX, GPS_TX);
-  delay(10);
+  gps_uart_begin(GPS_BAUD, GPS_RX, GPS_TX); // ingest via event RX driver UART
   logf("[GPS] UART %d,%d @ %lu OK", GPS_RX, GPS_TX, (unsigned long)GPS_BAUD);
-  // Optional: baca sekilas NMEA untuk sanity (non-blocking singkat)
-  uint32_t start = millis();
-  while (millis() - start < 100) {
-    if (GPSSerial.available()) {
-      char c = (char)GPSSerial.read();
-      (void)c;
-      break;
-    }
-    ui_yield_step();
-  }
+  race_begin();  // race jalan dengan config default; tahap config menerapkan race.json dari SD
+  if (GPSCFG_ENABLE)
+    gpscfg_begin({GPSCFG_BAUD, GPSCFG_MEAS_MS, GPSCFG_DYNMODEL, GPSCFG_TIMEOUT_MS});
   return true;
 }
 
+// Setelah auto-config: reader dengan protokol yang benar-benar dikirim receiver
+static void start_gps_reader(GPSProto proto) {
+  gps_reader_begin(160, proto);    // line buffer untuk NMEA
+  pipeline_begin(PIPELINE_ENABLE); // opsional: GPS+race pindah ke task core 0
+  if (!pipeline_running()) sched_set_wait(gps_uart_wait);  // burst UART bangunkan job gps
+  s_gps_up = true;
+  logf("[GPS] Reader %s @ %lu bd", proto == GPS_PROTO_UBX ? "UBX NAV-PVT" : "NMEA",
+       (unsigned long)gps_uart_baud());
+}
+
+static void boot_json(JsonOut& j);
+static bool s_web_up = false;   // handleClient() hanya setelah server.begin()
+
 static bool init_webserver() {
   // ===== Race config API =====
+  // GET langsung ke socket lewat buffer tetap (httpout.h): tanpa JsonDocument di stack
+  // loop & tanpa String heap. ?compact=1 untuk poller (tanpa whitespace).
   server.on("/api/race", HTTP_GET, [](){
-    const RaceConfig& C = race_cfg();
-    StaticJsonDocument<4096> doc;
-    doc["arm_speed_kph"]     = C.arm_speed_kph;
-    doc["trigger_speed_kph"] = C.trigger_speed_kph;
-    doc["max_hdop_m"]        = C.max_hdop_m;
-    JsonArray arr = doc.createNestedArray("traps");
+    const RaceConfig& C = pipeline_race_cfg();
+    // last results (snapshot; aman dibaca walau race engine di core lain)
+    static RaceSnapshot RS;
+    pipeline_latest(RS);
+    RunLogStats L = runlog_stats();
+
+    http_out_begin(server, "application/json");
+    JsonOut j(!(server.hasArg("compact") && server.arg("compact") != "0"));
+    j.obj();
+    j.kv("arm_speed_kph",     C.arm_speed_kph);
+    j.kv("trigger_speed_kph", C.trigger_speed_kph);
+    j.kv("max_hdop_m",        C.max_hdop_m);
+    j.kv("max_hacc_m",        C.max_hacc_m);
+    j.kv("max_sacc_mps",      C.max_sacc_mps);
+    j.arr("traps");
     for (auto& t : C.traps){
-      JsonObject o = arr.createNestedObject();
-      o["name"] = t.name; o["at_m"] = t.at_m; o["window_m"] = t.window_m;
+      j.obj();
+      j.kv("name", t.name.c_str()); j.kv("at_m", t.at_m); j.kv("window_m", t.window_m);
+      j.end_obj();
     }
-    // last results
-    const RaceState& RS = race_state();
-    JsonObject rs = doc.createNestedObject("state");
-    rs["armed"] = RS.armed; rs["running"] = RS.running; rs["dist_m"] = RS.cum_dist_m;
-    JsonArray R = rs.createNestedArray("results");
-    for (auto& r : RS.results){
-      JsonObject o = R.createNestedObject();
-      o["name"]=r.name; o["at_m"]=r.at_m; o["crossed"]=r.crossed;
-      o["et_ms"]=r.et_ms; o["trap_kph"]=r.trap_kph;
+    j.end_arr();
+    j.obj("state");
+    j.kv("armed", RS.armed); j.kv("running", RS.running); j.kv("dist_m", RS.cum_dist_m);
+    j.arr("results");
+    if (!pipeline_running()){
+      // single loop: race engine milik task ini, semua hasil dengan nama utuh
+      for (const TrapResult& r : race_state().results){
+        j.obj();
+        j.kv("name", r.name.c_str()); j.kv("at_m", r.at_m); j.kv("crossed", r.crossed);
+        j.kv("et_ms", r.et_ms); j.kv("trap_kph", r.trap_kph);
+        j.end_obj();
+      }
+    } else {
+      for (uint8_t i=0; i<RS.n_results; ++i){
+        const auto& r = RS.results[i];
+        j.obj();
+        j.kv("name", r.name); j.kv("at_m", r.at_m); j.kv("crossed", r.crossed);
+        j.kv("et_ms", r.et_ms); j.kv("trap_kph", r.trap_kph);
+        j.end_obj();
+      }
     }
-    String out; serializeJsonPretty(doc, out);
-    server.send(200, "application/json", out);
+    j.end_arr();
+    // mode threaded: snapshot memuat maks RACE_SNAP_MAX_TRAPS hasil
+    uint32_t n_total = pipeline_running() ? RS.n_total : (uint32_t)race_state().results.size();
+    j.kv("n_total", n_total);
+    j.kv("truncated", pipeline_running() && n_total > RS.n_results);
+    j.end_obj();
+    j.obj("runlog");
+    j.kv("file_no", (uint32_t)L.file_no); j.kv("blocks", L.blocks); j.kv("recs", L.recs);
+    j.kv("dropped", L.dropped); j.kv("write_err", L.write_err); j.kv("flush_us_max", L.flush_us_max);
+    j.end_obj();
+    LiveStats V = live_stats();
+    j.obj("live");
+    j.kv("clients", (uint32_t)V.clients); j.kv("frames", V.frames); j.kv("sent", V.sent); j.kv("dropped", V.dropped);
+    j.end_obj();
+    UdpTelStats U = udptel_stats();
+    j.obj("udp");
+    j.kv("enabled", UDPTEL_ENABLE); j.kv("seq", U.seq); j.kv("sent", U.sent); j.kv("errors", U.errors);
+    j.end_obj();
+    CfgStoreStats K = cfgstore_stats();
+    j.obj("cfg");
+    j.kv("pending", (uint32_t)K.pending); j.kv("writes", K.writes); j.kv("errors", K.errors);
+    j.kv("write_ms_max", K.write_ms_max); j.kv("loaded_from", cfgstore_source_str(K.last_load));
+    j.end_obj();
+    j.end_obj();
+    http_out_end();
   });
 
   server.on("/api/race", HTTP_POST, [](){
@@ -158,10 +197,12 @@ static bool init_webserver() {
     auto err = deserializeJson(doc, server.arg("plain"));
     if (err){ server.send(400, "text/plain", err.c_str()); return; }
 
-    RaceConfig cfg = race_cfg(); // copy
+    RaceConfig cfg = pipeline_race_cfg(); // copy
     if (doc.containsKey("arm_speed_kph"))     cfg.arm_speed_kph     = doc["arm_speed_kph"];
     if (doc.containsKey("trigger_speed_kph")) cfg.trigger_speed_kph = doc["trigger_speed_kph"];
     if (doc.containsKey("max_hdop_m"))        cfg.max_hdop_m        = doc["max_hdop_m"];
+    if (doc.containsKey("max_hacc_m"))        cfg.max_hacc_m        = doc["max_hacc_m"];
+    if (doc.containsKey("max_sacc_mps"))      cfg.max_sacc_mps      = doc["max_sacc_mps"];
     if (doc["traps"].is<JsonArray>()){
       cfg.traps.clear();
       for (JsonObject t : doc["traps"].as<JsonArray>()){
@@ -172,17 +213,12 @@ static bool init_webserver() {
         if (tr.at_m>0) cfg.traps.push_back(tr);
       }
     }
-    // apply runtime + save
-    race_cfg() = cfg;
-    bool saved = race_save(race_cfg());
-    logf("[RACE] Config save: %s", saved?"OK":"FAIL");
-
-    // update gating ke filter GPS
-    GPSFilterTuning tune; tune.max_hdop_m = cfg.max_hdop_m; gps_set_filter_tuning(tune);
-
-    // reset state biar siap run baru
-    race_reset();
-    server.send(200, "text/plain", "OK");
+    // apply runtime (gating filter GPS & reset state biar siap run baru); SD tidak
+    // disentuh di sini: race_save() hanya antri, job "cfg" menulis saat idle
+    bool queued = race_save(cfg);
+    pipeline_race_apply(cfg);
+    logf("[RACE] Config applied, save %s", queued ? "queued" : "FAILED (too large)");
+    server.send(queued ? 200 : 507, "text/plain", queued ? "OK" : "applied, not saved");
   });
 
   server.on("/api/race/arm", HTTP_POST, [](){
@@ -191,31 +227,107 @@ static bool init_webserver() {
     auto err = deserializeJson(doc, server.arg("plain"));
     if (err){ server.send(400, "text/plain", err.c_str()); return; }
     bool on = doc["arm"] | true;
-    race_arm(on);
+    pipeline_race_arm(on);
     server.send(200, "text/plain", on?"ARMED":"DISARMED");
   });
 
   server.on("/api/race/reset", HTTP_POST, [](){
-    race_reset();
+    pipeline_race_reset();
     server.send(200, "text/plain", "OK");
   });
 
+  // ===== Run log export (streaming chunked, lihat runexport.h) =====
+  server.on("/api/runs", HTTP_GET, [](){ runexport_list(server); });
+  server.on(UriBraces("/api/runs/{}"), HTTP_GET, [](){
+    uint16_t id; RunFmt fmt;
+    if (!runexport_parse(server.pathArg(0), id, fmt)) {
+      server.send(400, "text/plain", "use /api/runs/<id>.csv|gpx|vbo"); return;
+    }
+    bool running_only = server.hasArg("running") && server.arg("running") != "0";
+    if (!runexport_send(server, id, fmt, running_only)) server.send(404, "text/plain", "no such run");
+  });
+
+  // /log?since=<seq>: hanya baris baru, langsung dari ring. X-Log-Next = since berikutnya;
+  // X-Log-First > since berarti baris di antaranya sudah tertimpa.
   server.on("/log", [](){
-    server.send(200, "text/plain", logview_get_text());
+    dlog_drain();  // event biner tertunda jadi teks dulu
+    uint32_t since = server.hasArg("since") ? strtoul(server.arg("since").c_str(), nullptr, 10) : 0;
+    uint32_t next = logview_seq();
+    uint32_t first = min(max(since, logview_oldest()), next);
+    server.sendHeader("X-Log-Next", String(next));
+    server.sendHeader("X-Log-First", String(first));
+    server.sendHeader("Cache-Control", "no-cache");
+    // batas akhir dibekukan di logview_read: baris yang masuk selama streaming ada di since=next
+    http_out_begin(server, "text/plain");
+    logview_read(since, [](const char* p, size_t n){ http_out_write(p, n); });
+    http_out_end();
+  });
+#if PERF_ENABLE
+  // Profiler: ?reset=1 kosongkan histogram, ?screen=1|0 layar debug di TFT
+  server.on("/api/perf", HTTP_GET, [](){
+    if (server.hasArg("reset")) perf_reset();
+    if (server.hasArg("screen")) perf_screen(server.arg("screen") != "0");
+    http_out_begin(server, "application/json");
+    JsonOut j(!(server.hasArg("compact") && server.arg("compact") != "0"));
+    j.obj();
+    j.kv("cpu_mhz", (uint32_t)getCpuFrequencyMhz());
+    j.arr("stages");
+    for (uint8_t i = 0; i < PS_COUNT; ++i){
+      PerfSummary p = perf_summary((PerfStage)i);
+      j.obj();
+      j.kv("name", perf_stage_name((PerfStage)i)); j.kv("n", p.n);
+      j.kv("p50_us", p.p50_us); j.kv("p99_us", p.p99_us); j.kv("max_us", p.max_us); j.kv("mean_us", p.mean_us);
+      j.end_obj();
+    }
+    j.end_arr();
+    j.kv("sleep_ms", sched_sleep_ms());
+    j.arr("jobs");
+    for (uint8_t i = 0; i < sched_count(); ++i){
+      SchedStats S = sched_stats(i);
+      j.obj();
+      j.kv("name", S.name); j.kv("runs", S.runs); j.kv("late", S.late); j.kv("max_late_ms", S.max_late_ms);
+      j.end_obj();
+    }
+    j.end_arr();
+    j.end_obj();
+    http_out_end();
+  });
+#endif
+  server.on("/api/boot", HTTP_GET, [](){
+    http_out_begin(server, "application/json");
+    JsonOut j(!(server.hasArg("compact") && server.arg("compact") != "0"));
+    boot_json(j);
+    http_out_end();
   });
   server.on("/health", [](){ server.send(200, "text/plain", "OK"); });
   server.begin();
-  logln("[HTTP] Server started: GET /  /log  /health");
+  s_web_up = true;
+  logln("[HTTP] Server started: GET /  /log  /health  /api/runs  /api/perf  /api/boot");
   return true;
 }
 
-// ====== INIT (one-call) ======
-bool app_init() {
-  Serial.begin(115200);
-  delay(30);
-
+// ====== BOOT bertahap ======
+// Tahap sinkron (display, gps, sd) selesai di app_init(); sisanya maju tiap tick job
+// "boot" di scheduler. Tahap jalan bila semua dependensinya selesai (OK atau gagal),
+// jadi Wi-Fi yang gagal join tidak pernah menunda timing run. Reader GPS + race mulai
+// di tahap gpscfg, setelah receiver dikonfigurasi (atau gagal dan jalan apa adanya).
+enum BootStageId : uint8_t { BOOT_DISPLAY, BOOT_GPS, BOOT_GPSCFG, BOOT_SD, BOOT_CONFIG, BOOT_RUNLOG, BOOT_WIFI, BOOT_WEB, BOOT_COUNT };
+enum BootRes : uint8_t { BR_PENDING, BR_OK, BR_FAILED };
+
+struct BootStage {
+  const char* name;
+  bool     sync;           // dijalankan di app_init()
+  uint8_t  deps;           // bitmask (1 << BOOT_*)
+  BootRes (*step)();       // dipanggil berulang sampai != BR_PENDING
+  BootRes  res;
+  bool     started;
+  uint32_t t_start_ms, t_done_ms;
+};
+
+static BootRes step_display() {
   // LVGL core
   lv_init();
+  lv_tick_set_cb([]() -> uint32_t { return millis(); }); // tanpa lv_tick_inc di loop
   lv_log_register_print_cb(logview_lvgl_log_cb); // route LVGL logs ke logger kita
 
   // TFT
@@ -241,69 +353,211 @@ bool app_init() {
   logview_init("Welcome — Racing UI");
   logf("[BOOT] LVGL %d.%d.%d", (int)lv_version_major(), (int)lv_version_minor(), (int)lv_version_patch());
   logf("[BOOT] Free heap: %u", (unsigned)ESP.getFreeHeap());
+  return BR_OK;
+}
 
-  // Peripherals
-  init_sdcard();
-  init_wifi();
-  init_gps();
-    // ===== Race config =====
-    race_load(race_cfg()) ? logln("[RACE] Loaded /config/race.json")
-    : logln("[RACE] Using default race config");
-
-    // Sinkronkan gating HDOP dari race ke filter GPS
-    GPSFilterTuning tune;
-    tune.max_hdop_m = race_cfg().max_hdop_m;
-    gps_set_filter_tuning(tune);
-
-    // ===== GPS reader =====
-    gps_reader_begin(160); // line buffer
-    race_begin();          // siapin state
-
+static BootRes step_gps() { return init_gps() ? BR_OK : BR_FAILED; }
+static BootRes step_sd() {
+  if (!init_sdcard()) return BR_FAILED;
+  cfgstore_begin(CFG_SAVE_QUIET_MS);  // write-behind config aktif setelah SD siap
+  return BR_OK;
+}
 
-  init_webserver();
+// Auto-config receiver: satu langkah non-blocking per tick job boot. Gagal tetap
+// menjalankan reader (protokol/baud yang terdeteksi), hanya status boot "FAIL".
+static BootRes step_gpscfg() {
+  if (!GPSCFG_ENABLE) { start_gps_reader(GPS_PROTO_NMEA); return BR_OK; }
+  GpsCfgResult r = gpscfg_poll();
+  if (r == GCR_RUNNING) return BR_PENDING;
+  start_gps_reader(gpscfg_status().proto);
+  return r == GCR_OK ? BR_OK : BR_FAILED;
+}
 
-  logln("[BOOT] Init sequence done.");
-  return true;
+static BootRes step_config() {
+  static RaceSnapshot snap;
+  pipeline_latest(snap);
+  if (snap.armed) return BR_PENDING;  // apply = reset race: jangan potong run yang sudah armed
+  static RaceConfig cfg;
+  bool ok = race_load(cfg);
+  if (ok) logf("[RACE] Loaded %s (%s)", RACE_PATH, cfgstore_source_str(cfgstore_stats().last_load));
+  else     logln("[RACE] Using default race config");
+  if (ok) pipeline_race_apply(cfg);   // config + gating HDOP/hAcc/sAcc filter GPS
+  return ok ? BR_OK : BR_FAILED;
 }
 
-// ====== LOOP (non-blocking, tight cadence) ======
-void app_loop() {
-  static uint32_t last_tick = 0;
-  static uint32_t last_run  = 0;
-  static uint32_t last_ws   = 0;
+static BootRes step_runlog() {
+  if (!RUNLOG_ENABLE) return BR_OK;
+  return runlog_begin() ? BR_OK : BR_FAILED;  // log biner tiap fix ke /runs (background)
+}
 
-  constexpr uint32_t TICK_MS = 2;
-  constexpr uint32_t RUN_MS  = 2;
-  constexpr uint32_t WS_MS   = 2;   // webserver polling
+static BootRes step_wifi() {
+  static uint32_t t0 = 0;
+  if (!t0) {
+    WiFi.mode(WIFI_STA);
+    WiFi.setAutoReconnect(true);  // join gagal: stack Wi-Fi tetap mencoba di belakang
+    WiFi.begin(WIFI_SSID, WIFI_PASS);
+    logf("[WiFi] Connecting to %s ...", WIFI_SSID);
+    t0 = millis() | 1;
+    return BR_PENDING;
+  }
+  if (WiFi.status() == WL_CONNECTED) {
+    logf("[WiFi] OK: %s", WiFi.localIP().toString().c_str());
+    return BR_OK;
+  }
+  if (millis() - t0 < WIFI_JOIN_TIMEOUT_MS) return BR_PENDING;
+  logln("[WiFi] FAILED (web tetap jalan, auto-reconnect)");
+  return BR_FAILED;
+}
 
-  uint32_t now = millis();
+static BootRes step_web() {
+  init_webserver();
+  live_begin();          // SSE push per epoch di :LIVE_PORT/live
+  udptel_begin();        // opsional: paket biner per fix via UDP broadcast/multicast
+  return BR_OK;
+}
 
-  // LVGL tick
-  while ((now - last_tick) >= TICK_MS) {
-    lv_tick_inc(TICK_MS);
-    last_tick += TICK_MS;
+#define BOOT_DEP(x) (1u << (x))
+static BootStage s_boot[BOOT_COUNT] = {
+  {"display", true,  0,                                   step_display, BR_PENDING, false, 0, 0},
+  {"gps",     true,  BOOT_DEP(BOOT_DISPLAY),              step_gps,     BR_PENDING, false, 0, 0},
+  {"gpscfg",  false, BOOT_DEP(BOOT_GPS),                  step_gpscfg,  BR_PENDING, false, 0, 0},
+  {"sd",      true,  BOOT_DEP(BOOT_DISPLAY),              step_sd,      BR_PENDING, false, 0, 0},
+  {"config",  false, BOOT_DEP(BOOT_GPSCFG) | BOOT_DEP(BOOT_SD), step_config, BR_PENDING, false, 0, 0},
+  {"runlog",  false, BOOT_DEP(BOOT_SD),                   step_runlog,  BR_PENDING, false, 0, 0},
+  {"wifi",    false, BOOT_DEP(BOOT_DISPLAY),              step_wifi,    BR_PENDING, false, 0, 0},
+  {"web",     false, BOOT_DEP(BOOT_WIFI),                 step_web,     BR_PENDING, false, 0, 0},
+};
+static uint32_t s_first_fix_ms = 0;
+static bool     s_boot_reported = false;
+
+// Majukan tahap yang dependensinya selesai (urutan tabel = urutan dependensi);
+// return true bila semua tahap selesai
+static bool boot_advance(bool sync_only) {
+  bool all = true;
+  for (BootStage& st : s_boot) {
+    if (st.res != BR_PENDING) continue;
+    all = false;
+    if (sync_only && !st.sync) continue;
+    bool ready = true;
+    for (uint8_t d = 0; d < BOOT_COUNT; ++d)
+      if ((st.deps & BOOT_DEP(d)) && s_boot[d].res == BR_PENDING) ready = false;
+    if (!ready) continue;
+    if (!st.started) { st.started = true; st.t_start_ms = millis(); }
+    st.res = st.step();
+    if (st.res != BR_PENDING) st.t_done_ms = millis();
   }
+  return all;
+}
 
-  // LVGL service + DMA poll
-  if ((now - last_run) >= RUN_MS) {
-    poll_dma_complete();
-    lv_timer_handler();
-    last_run = now;
-  }
+static void boot_report() {
+  for (const BootStage& st : s_boot)
+    logf("[BOOT] %-7s %-6s @%5lu ms  %5lu ms", st.name, st.res == BR_OK ? "ok" : "FAIL",
+         (unsigned long)st.t_start_ms, (unsigned long)(st.t_done_ms - st.t_start_ms));
+}
 
-  // WebServer
-  if ((now - last_ws) >= WS_MS) {
-    server.handleClient();
-    last_ws = now;
+static void boot_json(JsonOut& j) {
+  j.obj();
+  j.kv("first_fix_ms", s_first_fix_ms);
+  j.arr("stages");
+  for (const BootStage& st : s_boot) {
+    j.obj();
+    j.kv("name", st.name);
+    j.kv("state", st.res == BR_OK ? "ok" : st.res == BR_FAILED ? "failed" : st.started ? "running" : "waiting");
+    j.kv("start_ms", st.t_start_ms);
+    j.kv("dur_ms", (uint32_t)(st.res != BR_PENDING ? st.t_done_ms - st.t_start_ms : 0));
+    j.end_obj();
   }
-  // ---- GPS poll ----
-  GPSFix fx;
-  if (gps_poll(fx)) {
-    // render status / debug di log hanya saat invalid→valid atau event trap (sudah di race_update)
-    if (fx.valid) {
-      race_update(fx);
+  j.end_arr();
+  GpsCfgStatus g = gpscfg_status();
+  j.obj("gps");
+  j.kv("auto", GPSCFG_ENABLE);
+  j.kv("result", GPSCFG_ENABLE ? gpscfg_result_str(g.res) : "off");
+  j.kv("state", g.state);
+  j.kv("baud", gps_uart_baud());
+  j.kv("found_baud", g.found_baud);
+  j.kv("proto", g.proto == GPS_PROTO_UBX ? "ubx" : "nmea");
+  j.kv("pvt_ms", (uint32_t)g.pvt_ms);
+  j.kv("acks", (uint32_t)g.acks); j.kv("naks", (uint32_t)g.naks); j.kv("retries", (uint32_t)g.retries);
+  j.kv("dur_ms", g.dur_ms);
+  j.end_obj();
+  j.end_obj();
+}
+
+static uint32_t job_boot() {
+  bool all = boot_advance(false);
+  if (all && !s_boot_reported) { boot_report(); s_boot_reported = true; }
+  if (!s_first_fix_ms) {
+    static RaceSnapshot snap;
+    pipeline_latest(snap);
+    if (snap.fix.valid) {
+      s_first_fix_ms = millis();
+      logf("[BOOT] First valid fix @%lu ms", (unsigned long)s_first_fix_ms);
     }
   }
+  return (all && s_first_fix_ms) ? 1000 : SCHED_PERIOD;  // boot selesai: cukup jarang
+}
 
-  // TODO: tempatkan task lain (GPS parsing, dsb) di sini, tetap non-blocking.
+// ====== LOOP (scheduler: job jatuh tempo saja, tidur di antaranya) ======
+// GPS ingest + race_update per fix; no-op selama auto-config receiver atau bila task pipeline jalan
+static uint32_t job_gps(){
+  if (!s_gps_up) return SCHED_PERIOD;
+  if (pipeline_running()) return 1000;
+  pipeline_poll();
+  return SCHED_PERIOD;
+}
+
+static uint32_t job_lvgl(){
+  { PERF_SCOPE(PS_DMA);  poll_dma_complete(); }
+  uint32_t next;
+  { PERF_SCOPE(PS_LVGL); next = lv_timer_handler(); }
+  if (s_dma_busy) return 1;  // flush DMA berjalan: cek selesai secepatnya
+  return (next == LV_NO_TIMER_READY) ? SCHED_PERIOD : min<uint32_t>(next, LVGL_MAX_IDLE_MS);
+}
+
+static uint32_t job_http(){
+  if (!s_web_up) return SCHED_PERIOD;
+  PERF_SCOPE(PS_HTTP); server.handleClient(); return SCHED_PERIOD;
+}
+static uint32_t job_live(){ PERF_SCOPE(PS_LIVE); live_poll(); udptel_poll(); return SCHED_PERIOD; }
+
+// Config tertunda ditulis ke SD hanya di luar run: armed/running = jalur timing aktif
+static uint32_t job_cfg(){
+  static RaceSnapshot snap;
+  pipeline_latest(snap);
+  cfgstore_poll(!snap.armed && !snap.running);
+  return SCHED_PERIOD;
+}
+
+// Log dari task lain + event dlog biner diformat di sini (di luar jalur timing)
+static uint32_t job_log(){ PERF_SCOPE(PS_LOG); dlog_drain(); logview_poll(); return SCHED_PERIOD; }
+
+static void init_sched() {
+  // prioritas: GPS/race > telemetri > LVGL > HTTP > log
+  // pipeline baru mulai setelah tahap gpscfg; hook wait dipasang di start_gps_reader()
+  sched_add("gps", job_gps, SCHED_GPS_MS, 4, 2, true);  // bangun langsung oleh burst UART
+  sched_add("live", job_live, SCHED_LIVE_MS, 3, 10);
+  sched_add("lvgl", job_lvgl, LVGL_MAX_IDLE_MS, 2, 10);
+  sched_add("http", job_http, SCHED_HTTP_MS, 1, 20);
+  sched_add("log",  job_log,  SCHED_LOG_MS,  0, 100);
+  sched_add("boot", job_boot, SCHED_BOOT_MS, 1, 50);   // Wi-Fi/web/config di latar belakang
+  sched_add("cfg",  job_cfg,  SCHED_CFG_MS,  0, 1000); // tulis SD config: paling akhir
+}
+
+// ====== INIT (one-call) ======
+bool app_init() {
+  Serial.begin(115200);
+  delay(30);
+
+  // Tahap sinkron: display -> GPS -> SD. Config, run logger, Wi-Fi dan webserver
+  // maju di app_loop() sehingga GPS + timing hidup tanpa menunggu join Wi-Fi.
+  boot_advance(true);
+  init_sched();
+
+  logf("[BOOT] Core up @%lu ms; Wi-Fi/web continue in background", (unsigned long)millis());
+  return s_boot[BOOT_DISPLAY].res == BR_OK;
+}
+
+// ====== LOOP ======
+void app_loop() {
+  sched_run();
 }
@@ -0,0 +1,219 @@
+/*
+ * File: live.cpp
+ * Description: SSE server on its own port with per-client bounded frame queues and non-blocking socket writes. Generated by AI for clarity.
+ */
+#include "live.h"
+#include "global.h"
+#include "logview.h"
+#include "pipeline.h"
+#include <lwip/sockets.h>
+#include <stdarg.h>
+
+// Frame penuh terburuk: header + RACE_SNAP_MAX_TRAPS trap (nama maks + angka lebar) + penutup
+static constexpr size_t   FRAME_HDR_MAX  = 160;  // "data: {seq,t,kph,d,st,q,sv,full" + ",\"tr\":["
+static constexpr size_t   FRAME_TRAP_MAX = sizeof(RaceSnapshot::results[0].name) + 80;
+static constexpr size_t   FRAME_TAIL     = 16;   // "],\"trunc\":1}\n\n" selalu muat
+static constexpr size_t   FRAME_MAX      = FRAME_HDR_MAX + RACE_SNAP_MAX_TRAPS * FRAME_TRAP_MAX + FRAME_TAIL;
+static constexpr size_t   REQ_MAX       = 48;    // cukup untuk baris "GET /live ..."
+static constexpr uint32_t HS_TIMEOUT_MS = 2000;
+static constexpr uint32_t KEEPALIVE_MS  = 15000; // komentar SSE saat tidak ada fix
+
+struct Frame { uint16_t len; char b[FRAME_MAX]; };
+
+struct LiveClient {
+  WiFiClient c;
+  bool     active = false, streaming = false, need_full = false;
+  uint32_t t_open_ms = 0, t_tx_ms = 0;
+  char     req[REQ_MAX]; uint8_t req_n = 0;
+  uint32_t tail = 0;                  // 4 byte terakhir request (cari \r\n\r\n)
+  Frame    q[LIVE_QUEUE];
+  uint8_t  head = 0, count = 0;
+  uint16_t off = 0;                   // byte terkirim dari frame head
+  bool     pin_head = false;          // head = header HTTP: tidak boleh dibuang
+};
+
+static WiFiServer   s_srv(LIVE_PORT);
+static bool         s_started = false;
+static LiveClient   s_cl[LIVE_MAX_CLIENTS];
+static RaceSnapshot s_snap, s_prev;
+static uint32_t     s_last_seq = 0;
+static bool         s_have_prev = false;
+static Frame        s_delta, s_full;
+static LiveStats    ST{};
+
+// ===== Antrian per klien =====
+static void close_client(LiveClient& k, const char* why){
+  if (k.streaming) logf("[LIVE] Client closed (%s)", why);
+  k.c.stop();
+  k.active = k.streaming = false;
+  k.count = 0; k.off = 0;
+}
+
+static void enqueue(LiveClient& k, const char* s, size_t n){
+  if (n > FRAME_MAX) return;
+  if (k.count == LIVE_QUEUE){
+    // buang frame tertua yang belum mulai terkirim; klien perlu frame penuh lagi
+    uint8_t drop = (k.off > 0 || k.pin_head) ? 1 : 0;
+    for (uint8_t i = drop; i + 1 < k.count; ++i)
+      k.q[(k.head + i) % LIVE_QUEUE] = k.q[(k.head + i + 1) % LIVE_QUEUE];
+    k.count--;
+    k.need_full = true;
+    ST.dropped++;
+  }
+  Frame& f = k.q[(k.head + k.count) % LIVE_QUEUE];
+  memcpy(f.b, s, n); f.len = (uint16_t)n;
+  k.count++;
+  k.t_tx_ms = millis();
+}
+
+// Kirim sebanyak socket mau tanpa menunggu
+static void drain(LiveClient& k){
+  int fd = k.c.fd();
+  while (k.count){
+    Frame& f = k.q[k.head];
+    int n = ::send(fd, f.b + k.off, f.len - k.off, MSG_DONTWAIT);
+    if (n < 0){
+      if (errno == EAGAIN || errno == EWOULDBLOCK) return;  // buffer TCP penuh: coba lagi nanti
+      close_client(k, "send error"); return;
+    }
+    k.off += (uint16_t)n;
+    if (k.off < f.len) return;
+    k.off = 0; k.head = (k.head + 1) % LIVE_QUEUE; k.count--; k.pin_head = false;
+    ST.sent++;
+  }
+}
+
+// ===== Frame =====
+static size_t fput(Frame& f, size_t n, const char* fmt, ...) __attribute__((format(printf, 3, 4)));
+static size_t fput(Frame& f, size_t n, const char* fmt, ...){
+  if (n >= FRAME_MAX) return n;
+  va_list ap; va_start(ap, fmt);
+  int k = vsnprintf(f.b + n, FRAME_MAX - n, fmt, ap);
+  va_end(ap);
+  return (k < 0) ? n : min(n + (size_t)k, FRAME_MAX);
+}
+
+static bool trap_changed(uint8_t i){
+  if (!s_have_prev || i >= s_prev.n_results) return true;
+  const auto& a = s_snap.results[i]; const auto& b = s_prev.results[i];
+  return a.crossed != b.crossed || a.et_ms != b.et_ms || a.trap_kph != b.trap_kph || strcmp(a.name, b.name);
+}
+
+// full=false: hanya trap yang berubah; true: semua trap
+static void build(Frame& f, bool full){
+  const RaceSnapshot& S = s_snap;
+  size_t n = fput(f, 0, "data: {\"seq\":%lu,\"t\":%lu,\"kph\":%.2f,\"d\":%.2f,\"st\":%u,\"q\":%u,\"sv\":%u%s",
+                  (unsigned long)S.seq, (unsigned long)S.fix.gnss_ms, S.fix.sog_mps * 3.6f, S.cum_dist_m,
+                  (unsigned)((S.armed ? 1 : 0) | (S.running ? 2 : 0) | (S.fix.valid ? 4 : 0)),
+                  (unsigned)S.fix.fixQ, (unsigned)S.fix.sv, full ? ",\"full\":1" : "");
+  bool any = false, trunc = false;
+  for (uint8_t i = 0; i < S.n_results; ++i){
+    if (!full && !trap_changed(i)) continue;
+    const auto& r = S.results[i];
+    char nm[sizeof(r.name)];
+    for (size_t j = 0; j < sizeof(nm); ++j){  // nama trap dari user: jangan pecahkan JSON
+      char ch = r.name[j];
+      nm[j] = (ch == '"' || ch == '\\' || (ch && (uint8_t)ch < 0x20)) ? '_' : ch;
+      if (!ch) break;
+    }
+    nm[sizeof(nm) - 1] = 0;
+    size_t n0 = n;
+    n = fput(f, n, "%s{\"i\":%u,\"n\":\"%s\",\"at\":%.3f,\"c\":%u,\"et\":%.1f,\"kph\":%.2f}",
+             any ? "," : ",\"tr\":[", (unsigned)i, nm, r.at_m, (unsigned)r.crossed, r.et_ms, r.trap_kph);
+    // angka tak wajar: jangan sampai penutup JSON / "\n\n" ikut terpotong
+    if (n + FRAME_TAIL >= FRAME_MAX){ n = n0; trunc = true; break; }
+    any = true;
+  }
+  if (any) n = fput(f, n, "]");
+  n = fput(f, n, "%s}\n\n", trunc ? ",\"trunc\":1" : "");
+  f.len = (uint16_t)min(n, FRAME_MAX - 1);
+}
+
+// ===== Handshake =====
+static void handshake(LiveClient& k){
+  while (k.c.available()){
+    char ch = (char)k.c.read();
+    if (k.req_n < REQ_MAX - 1) k.req[k.req_n++] = ch;
+    k.tail = (k.tail << 8) | (uint8_t)ch;
+    if (k.tail != 0x0D0A0D0Au) continue;
+    k.req[k.req_n] = 0;
+    if (strncmp(k.req, "GET /live", 9) != 0 || (k.req[9] != ' ' && k.req[9] != '?')){
+      static const char NF[] = "HTTP/1.1 404 Not Found\r\nContent-Length: 0\r\nConnection: close\r\n\r\n";
+      ::send(k.c.fd(), NF, sizeof(NF) - 1, MSG_DONTWAIT);
+      close_client(k, "404");
+      return;
+    }
+    static const char HDR[] =
+      "HTTP/1.1 200 OK\r\nContent-Type: text/event-stream\r\nCache-Control: no-cache\r\n"
+      "Connection: keep-alive\r\nAccess-Control-Allow-Origin: *\r\n\r\nretry: 1000\n\n";
+    k.streaming = true;
+    k.need_full = true;
+    enqueue(k, HDR, sizeof(HDR) - 1);
+    k.pin_head = true;
+    logln("[LIVE] Client streaming");
+    return;
+  }
+  if (millis() - k.t_open_ms > HS_TIMEOUT_MS) close_client(k, "handshake timeout");
+}
+
+bool live_begin(){
+  if (s_started) return true;
+  s_srv.begin();
+  s_srv.setNoDelay(true);
+  s_started = true;
+  logf("[LIVE] SSE on :%u/live", (unsigned)LIVE_PORT);
+  return true;
+}
+
+void live_poll(){
+  if (!s_started) return;
+
+  // klien baru
+  if (s_srv.hasClient()){
+    WiFiClient c = s_srv.available();
+    LiveClient* slot = nullptr;
+    for (auto& k : s_cl) if (!k.active){ slot = &k; break; }
+    if (!slot) c.stop();  // penuh
+    else {
+      // reset per field: LiveClient{} sementara berukuran ~3 KB di stack loop
+      LiveClient& k = *slot;
+      k.c = c; k.active = true; k.streaming = false; k.need_full = false;
+      k.t_open_ms = k.t_tx_ms = millis();
+      k.req_n = 0; k.tail = 0; k.head = 0; k.count = 0; k.off = 0; k.pin_head = false;
+      k.c.setNoDelay(true);
+    }
+  }
+
+  // satu frame per snapshot baru
+  pipeline_latest(s_snap);
+  bool fresh = (s_snap.seq != s_last_seq);
+  if (fresh){
+    if (s_have_prev && s_snap.n_results != s_prev.n_results)
+      for (auto& k : s_cl) k.need_full = true;  // daftar trap berubah (config baru)
+    build(s_delta, false);
+    bool full_built = false;
+    for (auto& k : s_cl){
+      if (!k.streaming) continue;
+      if (k.need_full){
+        if (!full_built){ build(s_full, true); full_built = true; }
+        k.need_full = false;
+        enqueue(k, s_full.b, s_full.len);
+      } else enqueue(k, s_delta.b, s_delta.len);
+    }
+    ST.frames++;
+    s_prev = s_snap; s_have_prev = true; s_last_seq = s_snap.seq;
+  }
+
+  uint8_t n = 0;
+  for (auto& k : s_cl){
+    if (!k.active) continue;
+    if (!k.c.connected()){ close_client(k, "disconnected"); continue; }
+    if (!k.streaming){ handshake(k); if (!k.active) continue; }
+    if (k.streaming && !k.count && millis() - k.t_tx_ms > KEEPALIVE_MS) enqueue(k, ": ka\n\n", 6);
+    drain(k);
+    if (k.streaming) n++;
+  }
+  ST.clients = n;
+}
+
+LiveStats live_stats(){ return ST; }
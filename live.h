@@ -0,0 +1,26 @@
+/*
+ * File: live.h
+ * Description: Server-Sent Events live telemetry: one compact delta frame per GNSS epoch pushed to every connected client. Generated by AI for clarity.
+ */
+#pragma once
+/* Telemetri live: GET http://<ip>:LIVE_PORT/live (EventSource di browser).
+   - Satu frame JSON compact per snapshot race (= per epoch GNSS): seq, waktu, speed,
+     jarak, state, kualitas fix, dan hanya hasil trap yang berubah sejak frame sebelumnya.
+   - Klien baru / klien yang kehilangan frame mendapat frame penuh ("full":1) berisi
+     semua trap, jadi delta berikutnya selalu konsisten.
+   - Tiap klien punya antrian terbatas (LIVE_QUEUE); socket ditulis non-blocking. Bila
+     klien lambat, frame tertua dibuang (data basi tidak berguna untuk display live).
+   - Semua kerja di loop() (konteks UI/HTTP), membaca snapshot pipeline: tidak ada
+     beban tambahan di jalur GPS/race. */
+#include <Arduino.h>
+
+struct LiveStats {
+  uint8_t  clients;   // klien streaming aktif
+  uint32_t frames;    // frame dibangun (per snapshot)
+  uint32_t sent;      // frame terkirim penuh ke klien
+  uint32_t dropped;   // frame dibuang karena antrian klien penuh
+};
+
+bool live_begin();     // buka server SSE (setelah init Wi-Fi)
+void live_poll();      // dari loop(): accept, handshake, bangun frame, kirim non-blocking
+LiveStats live_stats();
@@ -8,37 +8,107 @@
 static lv_obj_t* s_title = nullptr;
 static lv_obj_t* s_ta    = nullptr; // text area untuk log
 
-// Buffer log
-static String s_logbuf;
-static size_t s_maxlen = 6 * 1024; // ~6 KB
-
-// Helper: jaga panjang buffer
-static void trim_if_needed() {
-  if (s_logbuf.length() <= s_maxlen) return;
-  // buang 1/3 awal agar efisien
-  size_t cut = s_maxlen / 3;
-  s_logbuf.remove(0, cut);
-  // Tambahkan prefix agar log menandakan bagian awal terpangkas
-  s_logbuf = String(F("[trimmed]\n")) + s_logbuf;
+// Ring log: byte mentah + indeks awal baris per seq. Posisi absolut (uint32 naik terus)
+// jadi "sudah tertimpa?" cukup satu perbandingan; tulis O(panjang baris), tanpa memmove.
+static constexpr uint32_t RING_BYTES = 8192;   // pangkat 2
+static constexpr uint32_t RING_LINES = 256;    // pangkat 2; ~32 byte/baris rata-rata
+static constexpr size_t   LINE_MAX   = RING_BYTES / 4;
+static char     s_ring[RING_BYTES];
+static uint32_t s_lpos[RING_LINES];            // posisi absolut awal baris seq (seq % RING_LINES)
+static uint32_t s_wr = 0;                      // total byte pernah ditulis
+static uint32_t s_seq = 0;                     // seq baris berikutnya
+static uint32_t s_first = 0;                   // seq tertua yang masih utuh di ring
+
+// Render panel: baris baru hanya ditandai; timer LVGL menyalin ekor ring ke textarea
+// paling sering tiap RENDER_MS, satu set_text per batch, dan dilewati bila layar log
+// tidak tampil. Isi textarea dibatasi baris yang muat di layar.
+static constexpr uint32_t RENDER_MS  = 250;
+static constexpr uint32_t VIEW_LINES = 32;     // batas atas baris di panel
+static constexpr size_t   VIEW_BYTES = 2048;
+static char     s_view[VIEW_BYTES + 1];
+static uint32_t s_shown_seq = 0;               // s_seq saat render terakhir
+static uint32_t s_view_rows = 0;               // baris yang muat (dihitung saat render pertama)
+
+// Task pemilik LVGL; log dari task lain masuk antrean tetap (tanpa heap)
+static TaskHandle_t s_ui_task = nullptr;
+static portMUX_TYPE s_pend_mux = portMUX_INITIALIZER_UNLOCKED;
+static char   s_pend[1024];
+static size_t s_pend_len = 0;
+static uint32_t s_pend_drop = 0;
+
+static void ring_put(const char* p, size_t n){
+  if (n > LINE_MAX) n = LINE_MAX;              // baris raksasa: potong, jangan habiskan ring
+  s_lpos[s_seq & (RING_LINES - 1)] = s_wr;
+  uint32_t o = s_wr & (RING_BYTES - 1);
+  size_t k = min((size_t)(RING_BYTES - o), n);
+  memcpy(s_ring + o, p, k);
+  memcpy(s_ring, p + k, n - k);
+  s_wr += n; s_seq++;
+  // buang baris tertua yang tertimpa byte-nya atau slot indeksnya
+  while (s_first < s_seq && (s_seq - s_first > RING_LINES || s_wr - s_lpos[s_first & (RING_LINES - 1)] > RING_BYTES))
+    s_first++;
 }
 
 // Tulis ke Serial dan ke text area
 static void append_and_render(const String& lineWithNL) {
+  if (s_ui_task && xTaskGetCurrentTaskHandle() != s_ui_task) {
+    // LVGL & ring log bukan thread-safe: titip, dirender di logview_poll()
+    size_t n = lineWithNL.length();
+    portENTER_CRITICAL(&s_pend_mux);
+    if (s_pend_len + n <= sizeof(s_pend)) { memcpy(s_pend + s_pend_len, lineWithNL.c_str(), n); s_pend_len += n; }
+    else s_pend_drop++;
+    portEXIT_CRITICAL(&s_pend_mux);
+    return;
+  }
   Serial.print(lineWithNL);
-  s_logbuf += lineWithNL;
-  trim_if_needed();
-
-  if (s_ta) {
-    lv_textarea_add_text(s_ta, lineWithNL.c_str());
-    lv_textarea_set_cursor_pos(s_ta, LV_TEXTAREA_CURSOR_LAST);
-    // Scroll to bottom
-    lv_obj_scroll_to_y(s_ta, LV_COORD_MAX, LV_ANIM_OFF);
+  // satu seq per baris (blok titipan logview_poll bisa berisi banyak baris)
+  const char* p = lineWithNL.c_str();
+  const char* e = p + lineWithNL.length();
+  while (p < e) {
+    const char* nl = (const char*)memchr(p, '\n', e - p);
+    const char* q = nl ? nl + 1 : e;
+    ring_put(p, q - p);
+    p = q;
   }
+  // panel dirender batch oleh render_cb(): tidak ada relayout LVGL di jalur logf()
 }
 
-void logview_set_maxlen(size_t maxlen) { s_maxlen = maxlen; }
+// Salin ekor ring (s_view_rows baris terakhir, maks VIEW_BYTES) ke s_view
+static size_t build_view(){
+  uint32_t seq = (s_seq - s_first > s_view_rows) ? s_seq - s_view_rows : s_first;
+  if (seq == s_seq) return 0;
+  uint32_t pos = s_lpos[seq & (RING_LINES - 1)];
+  if (s_wr - pos > VIEW_BYTES) pos = s_wr - VIEW_BYTES;  // baris panjang: potong di depan
+  size_t n = 0;
+  while (pos != s_wr){
+    uint32_t o = pos & (RING_BYTES - 1);
+    size_t k = min((size_t)(s_wr - pos), (size_t)(RING_BYTES - o));
+    memcpy(s_view + n, s_ring + o, k);
+    n += k; pos += k;
+  }
+  if (n && s_view[n - 1] == '\n') n--;  // tanpa baris kosong di bawah
+  s_view[n] = 0;
+  return n;
+}
+
+static void render_cb(lv_timer_t*){
+  if (!s_ta || s_shown_seq == s_seq) return;
+  if (lv_obj_get_screen(s_ta) != lv_screen_active() || lv_obj_has_flag(s_ta, LV_OBJ_FLAG_HIDDEN)) return;
+  if (!s_view_rows){
+    int32_t lh = lv_font_get_line_height(lv_obj_get_style_text_font(s_ta, 0));
+    int32_t h  = lv_obj_get_content_height(s_ta);
+    s_view_rows = (lh > 0 && h > 0) ? constrain((uint32_t)(h / lh), 4u, VIEW_LINES) : VIEW_LINES;
+  }
+  build_view();
+  lv_textarea_set_text(s_ta, s_view);
+  lv_textarea_set_cursor_pos(s_ta, LV_TEXTAREA_CURSOR_LAST);
+  lv_obj_scroll_to_y(s_ta, LV_COORD_MAX, LV_ANIM_OFF);
+  s_shown_seq = s_seq;
+}
 
 void logview_init(const char* title) {
+  s_ui_task = xTaskGetCurrentTaskHandle();
+
   // Clean screen
   lv_obj_t* scr = lv_screen_active();
   lv_obj_clean(scr);
@@ -61,11 +131,11 @@ void logview_init(const char* title) {
   lv_obj_set_style_bg_color(s_ta, lv_color_hex(0x202020), 0);
   lv_obj_set_style_text_color(s_ta, lv_color_hex(0xE0E0E0), 0);
 
-  // Seed log buffer on screen
-  if (!s_logbuf.isEmpty()) {
-    lv_textarea_set_text(s_ta, s_logbuf.c_str());
-    lv_textarea_set_cursor_pos(s_ta, LV_TEXTAREA_CURSOR_LAST);
-  }
+  // Log yang sudah ada (boot awal) ikut render pertama
+  s_shown_seq = s_seq - 1;
+  s_view_rows = 0;
+  static lv_timer_t* t = nullptr;
+  if (!t) t = lv_timer_create(render_cb, RENDER_MS, nullptr);
 }
 
 void logln(const String& s) {
@@ -75,7 +145,7 @@ void logln(const String& s) {
 }
 
 void logf(const char* fmt, ...) {
-  static char buf[256];
+  char buf[256];  // di stack: logf dipanggil dari beberapa task (runlog, GPS task)
   va_list ap;
   va_start(ap, fmt);
   vsnprintf(buf, sizeof(buf), fmt, ap);
@@ -85,10 +155,51 @@ void logf(const char* fmt, ...) {
   append_and_render(line);
 }
 
-String logview_get_text() {
-  return s_logbuf;
+void logview_poll() {
+  if (!s_pend_len) return; // baca tanpa lock: paling buruk terlambat satu putaran
+  static char local[sizeof(s_pend) + 1];
+  size_t n; uint32_t drop;
+  portENTER_CRITICAL(&s_pend_mux);
+  n = s_pend_len; memcpy(local, s_pend, n); s_pend_len = 0;
+  drop = s_pend_drop; s_pend_drop = 0;
+  portEXIT_CRITICAL(&s_pend_mux);
+  local[n] = 0;
+  if (drop) logf("[LOG] %lu baris dari task lain terbuang", (unsigned long)drop);
+  append_and_render(String(local));
 }
 
+uint32_t logview_read(uint32_t since, void (*out)(const char*, size_t)) {
+  // batas dibekukan di awal: baris yang masuk selama streaming ikut permintaan berikutnya
+  uint32_t seq = max(since, s_first), end_seq = s_seq;
+  if (seq > end_seq) seq = end_seq;            // klien dari boot sebelumnya: mulai dari baris terbaru
+  if (seq == end_seq) return end_seq;
+  uint32_t pos = s_lpos[seq & (RING_LINES - 1)], end = s_wr;
+  uint32_t done = 0;                           // baris lengkap terkirim
+  char last = '\n';                            // byte terakhir terkirim (baris terpotong?)
+  char piece[256];
+  while (pos != end) {
+    // out() bisa flush HTTP -> pipeline_poll() -> log baru menimpa ring: salin dulu per potong
+    if (s_wr - pos > RING_BYTES) {
+      // X-Log-Next sudah end_seq: klien harus tahu ada baris yang tidak pernah sampai
+      int n = snprintf(piece, sizeof(piece), "%s[log overrun: %lu lines lost]\n", last != '\n' ? "\n" : "",
+                       (unsigned long)(end_seq - seq - done));
+      out(piece, (size_t)n);
+      break;
+    }
+    uint32_t o = pos & (RING_BYTES - 1);
+    size_t k = min((size_t)(end - pos), min(sizeof(piece), (size_t)(RING_BYTES - o)));
+    memcpy(piece, s_ring + o, k);
+    pos += k;
+    for (size_t i = 0; i < k; ++i) done += (piece[i] == '\n');
+    last = piece[k - 1];
+    out(piece, k);
+  }
+  return end_seq;
+}
+
+uint32_t logview_seq() { return s_seq; }
+uint32_t logview_oldest() { return s_first; }
+
 void logview_lvgl_log_cb(lv_log_level_t level, const char* buf) {
   // Filter: tampilkan WARNING ke atas agar tidak bising
   (void)level;
@@ -4,7 +4,10 @@
  */
 #pragma once
 /* Serial + TFT logger. Menampilkan welcome + live boot/system log.
-   - Ring buffer supaya tidak boros RAM
+   - Ring byte tetap (8 KB) + seq per baris: logging O(panjang baris), /log?since=<seq>
+     hanya mengirim baris baru langsung dari ring
+   - Panel TFT dirender batch oleh timer LVGL (maks ~4x/detik), hanya bila layar log
+     tampil, dan hanya baris terakhir yang muat di layar: logf() tidak menyentuh LVGL
    - API printf-like: logf(), logln() */
 #include <Arduino.h>
 #include <lvgl.h>
@@ -19,11 +22,18 @@ void logln(const String& s);
 // printf-style log (otomatis newline). Contoh: logf("WiFi %s", "OK");
 void logf(const char* fmt, ...) __attribute__((format(printf, 1, 2)));
 
-// Ambil isi log untuk web endpoint
-String logview_get_text();
+// Stream baris dengan seq >= since (dijepit ke baris tertua yang masih ada) ke out().
+// Return seq berikutnya (dipakai klien sebagai since berikutnya). Hanya dari task UI
+// (pemilik ring).
+uint32_t logview_read(uint32_t since, void (*out)(const char*, size_t));
 
-// Opsional: batasi panjang buffer (default ~6KB)
-void logview_set_maxlen(size_t maxlen);
+// Seq baris log berikutnya (jumlah baris sejak boot) dan seq tertua yang masih di ring
+uint32_t logview_seq();
+uint32_t logview_oldest();
+
+// Baris log dari task lain (mis. task GPS) ditahan lalu dirender di sini.
+// Panggil rutin dari loop UI (task yang memanggil logview_init).
+void logview_poll();
 
 // Jadikan callback untuk lv_log_register_print_cb (akan route ke Serial + panel)
 void logview_lvgl_log_cb(lv_log_level_t level, const char* buf);
@@ -0,0 +1,118 @@
+/*
+ * File: perf.cpp
+ * Description: Histogram storage, percentile extraction and the optional LVGL debug screen for the loop profiler. Generated by AI for clarity.
+ */
+#include "perf.h"
+
+static const char* const NAMES[PS_COUNT] = {
+  "loop", "dma", "lvgl", "http", "gps", "race", "e2e", "live", "log",
+};
+
+const char* perf_stage_name(PerfStage s){ return (s < PS_COUNT) ? NAMES[s] : "?"; }
+
+#if PERF_ENABLE
+static constexpr uint8_t SUB = 2;                     // 4 sub-bucket per oktaf
+static constexpr uint8_t NBUCKET = (32 - SUB + 1) << SUB;
+
+struct Hist {
+  uint16_t b[NBUCKET];
+  uint32_t n;
+  uint32_t max;
+  uint64_t sum;
+};
+static Hist     H[PS_COUNT];
+static uint32_t s_mhz = 0;
+
+// Nilai < 2^SUB masuk bucket linear; di atasnya: oktaf (msb) + SUB bit di bawah msb
+static inline uint8_t bucket_of(uint32_t v){
+  if (v < (1u << SUB)) return (uint8_t)v;
+  uint8_t msb = 31 - __builtin_clz(v);
+  return (uint8_t)(((msb - SUB + 1) << SUB) | ((v >> (msb - SUB)) & ((1u << SUB) - 1)));
+}
+
+// Batas atas bucket (nilai representatif untuk persentil)
+static uint32_t bucket_hi(uint8_t i){
+  if (i < (1u << SUB)) return i;
+  uint8_t oct = (i >> SUB) + SUB - 1, sub = i & ((1u << SUB) - 1);
+  uint64_t lo = ((uint64_t)((1u << SUB) | sub)) << (oct - SUB);
+  uint64_t hi = lo + (1ull << (oct - SUB)) - 1;
+  return hi > 0xFFFFFFFFull ? 0xFFFFFFFFu : (uint32_t)hi;
+}
+
+void perf_add(PerfStage s, uint32_t cycles){
+  Hist& h = H[s];
+  uint16_t& c = h.b[bucket_of(cycles)];
+  if (c == 0xFFFF){ for (auto& x : h.b) x >>= 1; }  // jaga bentuk distribusi
+  c++;
+  h.n++;
+  h.sum += cycles;
+  if (cycles > h.max) h.max = cycles;
+}
+
+void perf_add_us(PerfStage s, uint32_t us){
+  if (!s_mhz) s_mhz = getCpuFrequencyMhz();
+  perf_add(s, us > 0xFFFFFFFFu / s_mhz ? 0xFFFFFFFFu : us * s_mhz);
+}
+
+PerfSummary perf_summary(PerfStage s){
+  if (!s_mhz) s_mhz = getCpuFrequencyMhz();
+  PerfSummary r{0, 0, 0, 0, 0};
+  if (s >= PS_COUNT) return r;
+  const Hist& h = H[s];
+  uint32_t tot = 0;
+  for (auto x : h.b) tot += x;
+  r.n = h.n;
+  if (!tot) return r;
+  const float k = 1.0f / (float)s_mhz;
+  uint32_t q50 = (tot + 1) / 2, q99 = tot - tot / 100, acc = 0;
+  bool got50 = false;
+  for (uint8_t i = 0; i < NBUCKET; ++i){
+    acc += h.b[i];
+    if (!got50 && acc >= q50){ r.p50_us = min(bucket_hi(i), h.max) * k; got50 = true; }
+    if (acc >= q99){ r.p99_us = min(bucket_hi(i), h.max) * k; break; }
+  }
+  r.max_us  = h.max * k;
+  r.mean_us = h.n ? (float)((double)h.sum / h.n) * k : 0;
+  return r;
+}
+
+void perf_reset(){ memset(H, 0, sizeof(H)); }
+#else
+PerfSummary perf_summary(PerfStage){ return PerfSummary{0, 0, 0, 0, 0}; }
+void perf_reset(){}
+#endif
+
+// ===== Layar debug =====
+static lv_obj_t*   s_scr = nullptr;
+static lv_obj_t*   s_lbl = nullptr;
+static lv_obj_t*   s_prev = nullptr;
+static lv_timer_t* s_tmr = nullptr;
+
+static void screen_cb(lv_timer_t*){
+  if (!s_scr || lv_screen_active() != s_scr) return;
+  static char txt[PS_COUNT * 48 + 48];
+  size_t n = snprintf(txt, sizeof(txt), "%-5s %7s %7s %7s %8s\n", "stage", "p50us", "p99us", "maxus", "n");
+  for (uint8_t i = 0; i < PS_COUNT && n < sizeof(txt); ++i){
+    PerfSummary p = perf_summary((PerfStage)i);
+    n += snprintf(txt + n, sizeof(txt) - n, "%-5s %7.1f %7.1f %7.0f %8lu\n", perf_stage_name((PerfStage)i),
+                  p.p50_us, p.p99_us, p.max_us, (unsigned long)p.n);
+  }
+  lv_label_set_text(s_lbl, txt);
+}
+
+void perf_screen(bool on){
+  if (!PERF_ENABLE) return;
+  if (on){
+    if (!s_scr){
+      s_scr = lv_obj_create(nullptr);
+      s_lbl = lv_label_create(s_scr);
+      lv_obj_set_style_text_font(s_lbl, LV_FONT_DEFAULT, 0);
+      lv_obj_align(s_lbl, LV_ALIGN_TOP_MID, 0, 4);
+      s_tmr = lv_timer_create(screen_cb, 1000, nullptr);
+    }
+    if (lv_screen_active() != s_scr){ s_prev = lv_screen_active(); lv_screen_load(s_scr); }
+    screen_cb(nullptr);
+  } else if (s_scr && lv_screen_active() == s_scr && s_prev){
+    lv_screen_load(s_prev);
+  }
+}
@@ -0,0 +1,59 @@
+/*
+ * File: perf.h
+ * Description: Per-stage loop profiler: cycle-counter durations into fixed log-bucket histograms (p50/p99/max). Generated by AI for clarity.
+ */
+#pragma once
+/* Profiler loop (PERF_ENABLE di global.h; 0 = hilang total, makro jadi kosong):
+   - PERF_SCOPE(stage) mengukur blok dengan cycle counter CPU; satu perf_add() = geser
+     bit + increment counter, tanpa lock (tiap stage hanya ditulis satu task).
+   - Histogram log2 dengan 4 sub-bucket per oktaf (resolusi ~19%), counter 16-bit yang
+     dibagi dua saat penuh, jadi persentil tetap benar tanpa reset.
+   - PS_E2E = latency byte terakhir kalimat GPS diterima -> race_update selesai.
+   Dibaca lewat GET /api/perf (JSON) dan layar debug opsional (perf_screen). */
+#include <Arduino.h>
+#include "global.h"
+
+enum PerfStage : uint8_t {
+  PS_LOOP,     // satu putaran job scheduler (tanpa tidur)
+  PS_DMA,      // poll_dma_complete()
+  PS_LVGL,     // lv_timer_handler()
+  PS_HTTP,     // server.handleClient()
+  PS_GPS,      // gps_poll() yang memproses kalimat
+  PS_RACE,     // race_update() + runlog_append()
+  PS_E2E,      // byte terakhir epoch diterima -> race_update selesai
+  PS_LIVE,     // live_poll() + udptel_poll()
+  PS_LOG,      // dlog_drain() + logview_poll()
+  PS_COUNT
+};
+
+struct PerfSummary {
+  uint32_t n;        // sampel sejak reset
+  float    p50_us, p99_us, max_us, mean_us;
+};
+
+#if PERF_ENABLE
+inline uint32_t perf_cycles(){ return ESP.getCycleCount(); }
+void perf_add(PerfStage s, uint32_t cycles);
+void perf_add_us(PerfStage s, uint32_t us);
+
+struct PerfScope {
+  PerfStage s; uint32_t c0;
+  explicit PerfScope(PerfStage st) : s(st), c0(perf_cycles()) {}
+  ~PerfScope(){ perf_add(s, perf_cycles() - c0); }
+};
+#define PERF_CAT2(a, b) a##b
+#define PERF_CAT(a, b) PERF_CAT2(a, b)
+#define PERF_SCOPE(stage) PerfScope PERF_CAT(_perf_, __LINE__)(stage)
+#else
+inline uint32_t perf_cycles(){ return 0; }
+inline void perf_add(PerfStage, uint32_t){}
+inline void perf_add_us(PerfStage, uint32_t){}
+#define PERF_SCOPE(stage) do {} while (0)
+#endif
+
+const char* perf_stage_name(PerfStage s);
+PerfSummary perf_summary(PerfStage s);
+void perf_reset();
+
+// Layar debug LVGL (tabel stage, refresh 1 Hz); off = kembali ke layar sebelumnya
+void perf_screen(bool on);
@@ -0,0 +1,154 @@
+/*
+ * File: pipeline.cpp
+ * Description: GPS/race task pinned to one core, publishing snapshots through a latest-value slot. Generated by AI for clarity.
+ */
+#include "pipeline.h"
+#include "global.h"
+#include "logview.h"
+#include "perf.h"
+#include "spsc_ring.h"
+#include "gps_uart.h"
+#include "runlog.h"
+
+// Perintah UI -> task GPS (jarang; pakai queue FreeRTOS, bukan hot path)
+enum PipeCmdOp : uint8_t { PC_ARM, PC_RESET, PC_APPLY };
+struct PipeCmd {
+  PipeCmdOp   op;
+  bool        on;    // PC_ARM
+  RaceConfig* cfg;   // PC_APPLY: heap copy, di-delete oleh task GPS
+};
+
+static SpscLatest<RaceSnapshot> s_latest;  // penuh tidak ada: snapshot lama ditimpa
+static QueueHandle_t s_cmdq = nullptr;
+static TaskHandle_t  s_task = nullptr;
+static RaceSnapshot  s_last{};     // snapshot terakhir sisi konsumen
+static RaceSnapshot  s_snap{};     // buffer kerja producer
+static RaceConfig    s_cfg_ui;     // salinan config sisi UI (mode threaded)
+
+bool pipeline_running(){ return s_task != nullptr; }
+uint32_t pipeline_dropped(){ return s_latest.skipped(); }
+
+// Producer: salin state race + fix ke slot terbaru. Hanya dari pemilik race engine.
+static void publish(){
+  RaceSnapshot& out = s_snap;
+  const RaceState& rs = race_state();
+  out.seq++;
+  out.gps = gps_stats();
+  out.armed = rs.armed; out.running = rs.running; out.cum_dist_m = rs.cum_dist_m;
+  out.n_results = (uint8_t)std::min<size_t>(rs.results.size(), RACE_SNAP_MAX_TRAPS);
+  out.n_total = (uint16_t)std::min<size_t>(rs.results.size(), 0xFFFF);
+  for (uint8_t i=0; i<out.n_results; ++i){
+    const TrapResult& r = rs.results[i];
+    auto& o = out.results[i];
+    strlcpy(o.name, r.name.c_str(), sizeof(o.name));
+    o.at_m = r.at_m; o.crossed = r.crossed; o.et_ms = r.et_ms; o.trap_kph = r.trap_kph;
+  }
+  s_latest.publish(out);
+}
+
+// Satu putaran: drain UART per epoch, update race, publish tiap fix
+// Kalimat yang sudah diproses parser (penanda gps_poll() benar-benar bekerja)
+static uint32_t sentences(){
+  const GPSStats& g = gps_stats();
+  return g.nmea_lines + g.ubx_pvt_ok + g.ubx_cks_fail;
+}
+
+static void poll_once(){
+  GPSFix fx;
+  for (;;){
+    uint32_t n0 = PERF_ENABLE ? sentences() : 0, c0 = perf_cycles();
+    bool got = gps_poll(fx);
+    // poll kosong (tanpa byte) tidak dicatat: akan menenggelamkan p50
+    if (PERF_ENABLE && (got || sentences() != n0)) perf_add(PS_GPS, perf_cycles() - c0);
+    if (!got) break;
+    c0 = perf_cycles();
+    if (fx.valid) race_update(fx);
+    runlog_append(fx, race_state());  // memcpy ke blok RAM; SD ditulis task logger
+    perf_add(PS_RACE, perf_cycles() - c0);
+    if (fx.valid) perf_add_us(PS_E2E, micros() - fx.rx_us);
+    s_snap.fix = fx;
+    publish();
+  }
+}
+
+// Eksekusi perintah di konteks pemilik race engine
+static void apply_cmd(const PipeCmd& c){
+  switch (c.op){
+    case PC_ARM:   race_arm(c.on); break;
+    case PC_RESET: race_reset();   break;
+    case PC_APPLY: {
+      race_cfg() = *c.cfg;
+      delete c.cfg;
+      GPSFilterTuning tune;
+      tune.max_hdop_m   = race_cfg().max_hdop_m;
+      tune.max_hacc_m   = race_cfg().max_hacc_m;
+      tune.max_sacc_mps = race_cfg().max_sacc_mps;
+      gps_set_filter_tuning(tune);
+      race_reset();
+      break;
+    }
+  }
+  publish(); // UI langsung lihat efek perintah
+}
+
+static void pipeline_task(void*){
+  for (;;){
+    PipeCmd c;
+    while (xQueueReceive(s_cmdq, &c, 0) == pdTRUE) apply_cmd(c);
+    poll_once();
+    // tidur sampai burst UART berikutnya (atau 2 ms untuk cek perintah/timeout epoch)
+    gps_uart_wait(2);
+  }
+}
+
+void pipeline_poll(){ if (!s_task) poll_once(); }
+
+bool pipeline_begin(bool threaded){
+  if (s_task) return true;
+  publish(); // snapshot awal (daftar trap) sebelum fix pertama
+  if (!threaded) return true;
+  s_cfg_ui = race_cfg();
+  s_cmdq = xQueueCreate(8, sizeof(PipeCmd));
+  if (!s_cmdq){ logln("[PIPE] Queue alloc FAILED"); return false; }
+  BaseType_t ok = xTaskCreatePinnedToCore(pipeline_task, "gps_race", PIPELINE_STACK,
+                                          nullptr, PIPELINE_PRIO, &s_task, PIPELINE_CORE);
+  if (ok != pdPASS){
+    s_task = nullptr;
+    logln("[PIPE] Task create FAILED, fallback single loop");
+    return false;
+  }
+  logf("[PIPE] GPS+race task on core %d, prio %d", (int)PIPELINE_CORE, (int)PIPELINE_PRIO);
+  return true;
+}
+
+bool pipeline_latest(RaceSnapshot& out){
+  bool fresh = s_latest.read_latest(s_last);
+  out = s_last;
+  return fresh;
+}
+
+// Kirim perintah; queue penuh berarti task GPS macet -> laporkan saja
+static void post(const PipeCmd& c){
+  if (xQueueSend(s_cmdq, &c, 0) != pdTRUE){
+    if (c.op == PC_APPLY) delete c.cfg;
+    logln("[PIPE] Command queue full");
+  }
+}
+
+void pipeline_race_arm(bool on){
+  if (!s_task){ race_arm(on); return; }
+  post({PC_ARM, on, nullptr});
+}
+
+void pipeline_race_reset(){
+  if (!s_task){ race_reset(); return; }
+  post({PC_RESET, false, nullptr});
+}
+
+void pipeline_race_apply(const RaceConfig& cfg){
+  if (!s_task){ apply_cmd({PC_APPLY, false, new RaceConfig(cfg)}); return; }
+  s_cfg_ui = cfg;
+  post({PC_APPLY, false, new RaceConfig(cfg)});
+}
+
+const RaceConfig& pipeline_race_cfg(){ return s_task ? s_cfg_ui : race_cfg(); }
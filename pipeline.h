@@ -0,0 +1,62 @@
+/*
+ * File: pipeline.h
+ * Description: Optional dual-core mode: GPS + race engine in a pinned task, snapshots to the UI core. Generated by AI for clarity.
+ */
+#pragma once
+/* Mode threaded (opt-in, lihat PIPELINE_ENABLE di global.h).
+   - Task prioritas tinggi di PIPELINE_CORE memegang GPSSerial, parser, dan race engine.
+   - Tiap epoch dipublikasikan sebagai RaceSnapshot ke slot lock-free (seqlock); yang
+     belum dibaca ditimpa, jadi konsumen yang telat tetap dapat state terbaru.
+   - UI/HTTP (core lain) hanya membaca snapshot & mengirim perintah; tidak pernah
+     menyentuh state race/GPS secara langsung.
+   Bila pipeline tidak jalan, semua fungsi jatuh ke jalur langsung (single loop). */
+#include <Arduino.h>
+#include "gps_read.h"
+#include "race.h"
+
+// Snapshot ukuran tetap (lintas core, tanpa heap): hanya trap pertama yang disalin dan
+// nama dipotong 15 karakter. Konsumen yang bisa membaca race engine langsung (mode
+// single loop) sebaiknya memakai race_state(); sisanya laporkan n_total.
+inline constexpr uint8_t RACE_SNAP_MAX_TRAPS = 8;
+
+// Salinan POD state GPS + race untuk konsumsi lintas core
+struct RaceSnapshot {
+  uint32_t seq;          // naik tiap snapshot
+  GPSFix   fix;          // fix terakhir (valid/invalid)
+  GPSStats gps;          // statistik parser
+  bool     armed;
+  bool     running;
+  float    cum_dist_m;
+  uint8_t  n_results;    // hasil yang disalin (maks RACE_SNAP_MAX_TRAPS)
+  uint16_t n_total;      // jumlah trap sebenarnya; > n_results = daftar terpotong
+  struct {
+    char  name[16];
+    float at_m;
+    bool  crossed;
+    float et_ms;
+    float trap_kph;
+  } results[RACE_SNAP_MAX_TRAPS];
+};
+
+// Panggil setelah gps_reader_begin() & race_begin(). threaded=true -> jalankan task
+// GPS/race; false (atau gagal buat task) -> mode single loop via pipeline_poll().
+bool pipeline_begin(bool threaded);
+bool pipeline_running();
+
+// Mode single loop: poll GPS + race + publish snapshot. No-op bila task jalan.
+void pipeline_poll();
+
+// Konsumen (UI/HTTP): ambil snapshot terbaru. false jika tidak ada yang baru;
+// out tetap berisi snapshot terakhir yang pernah diambil.
+bool pipeline_latest(RaceSnapshot& out);
+
+// Perintah ke race engine; di mode threaded dieksekusi oleh task GPS
+void pipeline_race_arm(bool on);
+void pipeline_race_reset();
+void pipeline_race_apply(const RaceConfig& cfg);  // config + tuning filter + reset
+
+// Config race untuk dibaca UI/HTTP (salinan sisi UI di mode threaded)
+const RaceConfig& pipeline_race_cfg();
+
+// Snapshot yang ditimpa sebelum sempat dibaca (konsumen lebih lambat dari epoch)
+uint32_t pipeline_dropped();
@@ -3,53 +3,48 @@
  * Description: Manages race configuration, state, and timing logic. Generated by AI for clarity.
  */
 #include "race.h"
-#include "global.h"
+#include "trace.h"
 #include "logview.h"
+#include "dlog.h"
+#include "cfgstore.h"
 #include <ArduinoJson.h>
-#include <SD.h>
 #include <math.h>
+#include <algorithm>
 
 static RaceConfig G;
 static RaceState  RS;
 
-// Ring buffer jejak untuk interpolasi (dist vs waktu vs speed)
-struct Sample { uint32_t t_ms; float dist_m; float sog_mps; double lat,lon; };
-static const size_t RB_N = 256;
-static Sample RB[RB_N];
-static size_t rb_head=0, rb_size=0;
-
-static inline void rb_push(const Sample& s){
-  RB[rb_head] = s;
-  rb_head = (rb_head + 1) % RB_N;
-  if (rb_size < RB_N) rb_size++;
-}
-static inline const Sample& rb_get_back(size_t i){ // i=0 last
-  size_t idx = (rb_head + RB_N - 1 - i) % RB_N;
-  return RB[idx];
-}
-
-static double hav_m(double lat1,double lon1,double lat2,double lon2){
-  static constexpr double R = 6371000.0;
-  double r1=lat1*M_PI/180.0, r2=lat2*M_PI/180.0, dlat=(lat2-lat1)*M_PI/180.0, dlon=(lon2-lon1)*M_PI/180.0;
-  double a = sin(dlat/2)*sin(dlat/2) + cos(r1)*cos(r2)*sin(dlon/2)*sin(dlon/2);
-  return R * 2 * atan2(sqrt(a), sqrt(1-a));
-}
+// Jejak run penuh (trace.h); segmen terbaru untuk crossing engine dipegang
+// terpisah karena jejak bisa di-decimate. Waktu = epoch GNSS (GPSFix::t_us)
+static TraceSample s_last;
+
+// Crossing engine: semua titik jarak (trap + ujung window) diurutkan sekali di
+// race_begin(); tiap fix hanya segmen terbaru [prev, now] yang dicek, cursor maju
+// melewati semua edge yang tercakup. Biaya per fix O(1) terhadap jumlah trap & panjang jejak.
+enum EdgeKind : uint8_t { EK_WIN_A, EK_TRAP, EK_WIN_B };
+struct Edge { float at_m; uint16_t trap; uint8_t kind; };
+struct EdgeTimes { uint32_t tA, tB; bool gotA, gotB; };
+static std::vector<Edge>      s_edges;   // urut naik at_m
+static std::vector<EdgeTimes> s_etimes;  // per trap (indeks = RS.results)
+static std::vector<float>     s_window;  // window_m per trap (tanpa cari nama)
+static size_t s_edge_i = 0;              // edge pertama yang belum dilewati
 
 RaceConfig& race_cfg(){ return G; }
 const RaceState& race_state(){ return RS; }
 
 static void fill_defaults(RaceConfig& cfg){ cfg = RaceConfig{}; }
 
-bool race_load(RaceConfig& out){
-  if (!SD.exists(RACE_PATH)) { fill_defaults(out); return false; }
-  File f = SD.open(RACE_PATH, FILE_READ);
-  if (!f) { fill_defaults(out); return false; }
+// JSON -> config; false bila tidak bisa di-parse (salinan berikutnya dicoba)
+static RaceConfig* s_load_out = nullptr;
+static bool parse_cfg(const char* data, size_t n){
   StaticJsonDocument<4096> doc;
-  auto err = deserializeJson(doc, f); f.close();
-  if (err){ fill_defaults(out); return false; }
+  if (deserializeJson(doc, data, n)) return false;
+  RaceConfig& out = *s_load_out;
   out.arm_speed_kph     = doc["arm_speed_kph"]     | 1.0f;
   out.trigger_speed_kph = doc["trigger_speed_kph"] | 5.0f;
   out.max_hdop_m        = doc["max_hdop_m"]        | 1.5f;
+  out.max_hacc_m        = doc["max_hacc_m"]        | 2.5f;
+  out.max_sacc_mps      = doc["max_sacc_mps"]      | 1.0f;
   out.traps.clear();
   if (doc["traps"].is<JsonArray>()){
     for (JsonObject t : doc["traps"].as<JsonArray>()){
@@ -63,13 +58,21 @@ bool race_load(RaceConfig& out){
   return true;
 }
 
+bool race_load(RaceConfig& out){
+  static char buf[CFGSTORE_READ_BYTES];
+  size_t n;
+  s_load_out = &out;
+  if (cfgstore_read(RACE_PATH, buf, sizeof(buf), n, parse_cfg) == CFG_SRC_NONE){ fill_defaults(out); return false; }
+  return true;
+}
+
 bool race_save(const RaceConfig& cfg){
-  File f = SD.open(RACE_PATH, FILE_WRITE, true);
-  if (!f) return false;
   StaticJsonDocument<4096> doc;
   doc["arm_speed_kph"]     = cfg.arm_speed_kph;
   doc["trigger_speed_kph"] = cfg.trigger_speed_kph;
   doc["max_hdop_m"]        = cfg.max_hdop_m;
+  doc["max_hacc_m"]        = cfg.max_hacc_m;
+  doc["max_sacc_mps"]      = cfg.max_sacc_mps;
   JsonArray arr = doc.createNestedArray("traps");
   for (auto& t : cfg.traps){
     JsonObject o = arr.createNestedObject();
@@ -77,66 +80,91 @@ bool race_save(const RaceConfig& cfg){
     o["at_m"] = t.at_m;
     o["window_m"] = t.window_m;
   }
-  bool ok = (serializeJsonPretty(doc, f) > 0);
-  f.close();
-  return ok;
+  // serialisasi di RAM saja; SD ditulis cfgstore_poll() di slice idle
+  static char buf[CFGSTORE_MAX_BYTES];
+  size_t n = serializeJsonPretty(doc, buf, sizeof(buf));
+  if (n == 0 || n + 1 >= sizeof(buf)) return false;  // kosong / terpotong
+  return cfgstore_put(RACE_PATH, buf, n);
 }
 
 void race_begin(){
   RS = RaceState{};
-  rb_head = 0; rb_size = 0;
+  trace_reset();
   // siapkan result entries
   RS.results.clear();
+  s_edges.clear(); s_window.clear();
   for (auto& t : G.traps){
+    uint16_t k = (uint16_t)RS.results.size();
     RS.results.push_back({t.name, t.at_m, false, 0, 0, 0.0f, 0.0f});
+    s_window.push_back(t.window_m);
+    s_edges.push_back({t.at_m, k, EK_TRAP});
+    if (t.window_m > 0){
+      s_edges.push_back({t.at_m - t.window_m*0.5f, k, EK_WIN_A});
+      s_edges.push_back({t.at_m + t.window_m*0.5f, k, EK_WIN_B});
+    }
   }
+  std::stable_sort(s_edges.begin(), s_edges.end(),
+                   [](const Edge& x, const Edge& y){ return x.at_m < y.at_m; });
+  s_etimes.assign(RS.results.size(), EdgeTimes{0, 0, false, false});
+  s_edge_i = 0;
 }
 
 void race_reset(){ race_begin(); logln("[RACE] Reset"); }
 void race_arm(bool on){
   RS.armed = on;
-  if (on){ RS.running=false; logln("[RACE] Armed"); }
-  else   { if (RS.running) logln("[RACE] Disarmed (was running)"); RS.running=false; }
+  if (on){ RS.running=false; dlog(DL_RACE_ARMED); }
+  else   { if (RS.running) dlog(DL_RACE_DISARMED_RUN); RS.running=false; }
 }
 
-// cari waktu crossing jarak X via interpolasi linear
-static bool interp_cross_time(float Xm, uint32_t& t_ms_out){
-  if (rb_size<2) return false;
-  // ambil dua sampel terakhir yang menyeberang X
-  const Sample* prev=nullptr; const Sample* now=nullptr;
-  float d_prev=0, d_now=0;
-  for (size_t i=0; i<rb_size; ++i){
-    const Sample& s = rb_get_back(i);
-    if (i==0){ now=&s; d_now=s.dist_m; continue; }
-    prev = now; d_prev = d_now;
-    now  = &s;  d_now  = s.dist_m;
-    if (d_prev < Xm && d_now >= Xm) break;
-    if (i == rb_size-1) return false;
-  }
-  if (!prev || !now) return false;
-  float f = (Xm - d_prev) / max( (d_now - d_prev), 1e-3f );
+// waktu crossing jarak X di dalam segmen prev->now (interpolasi linear)
+static uint32_t interp_seg(const TraceSample& prev, const TraceSample& now, float Xm){
+  float f = (Xm - prev.dist_m) / max( (now.dist_m - prev.dist_m), 1e-3f );
   f = constrain(f, 0.0f, 1.0f);
-  t_ms_out = (uint32_t)( prev->t_ms + f * (int32_t)(now->t_ms - prev->t_ms) );
-  return true;
+  // offset dihitung relatif ke prev agar float tidak memotong resolusi micros
+  return prev.t_us + (uint32_t)(int32_t)lroundf(f * (float)(int32_t)(now.t_us - prev.t_us));
 }
 
-// average speed pada window [Xm - w/2, Xm + w/2]
-static bool window_avg_speed(float Xm, float w, float& kph_out){
-  if (w <= 0) { kph_out = 0; return false; }
-  float A = Xm - w*0.5f, B = Xm + w*0.5f;
-  if (rb_size<2) return false;
-  uint32_t tA=0, tB=0;
-  if (!interp_cross_time(A, tA)) return false;
-  if (!interp_cross_time(B, tB)) return false;
-  float dt = (tB - tA) * 0.001f;
-  if (dt <= 0) return false;
-  kph_out = (w / dt) * 3.6f; // m/s -> km/h
-  return true;
+// selesaikan semua edge yang dilewati segmen prev->now (jarak monoton naik)
+static void resolve_edges(const TraceSample& prev, const TraceSample& now){
+  while (s_edge_i < s_edges.size() && s_edges[s_edge_i].at_m <= now.dist_m){
+    const Edge& ed = s_edges[s_edge_i++];
+    // edge <= jarak prev hanya mungkin di start (mis. window dimulai <= 0 m): tidak pernah diseberangi
+    if (ed.at_m <= prev.dist_m) continue;
+    uint32_t tX = interp_seg(prev, now, ed.at_m);
+    auto& r  = RS.results[ed.trap];
+    auto& et = s_etimes[ed.trap];
+    switch (ed.kind){
+      case EK_WIN_A: et.tA = tX; et.gotA = true; break;
+      case EK_TRAP:
+        if (r.crossed) break; // sudah tercatat di start sebelumnya (re-arm)
+        r.crossed = true;
+        r.t_start_us = RS.t_start_us;
+        r.t_cross_us = tX;
+        r.et_ms = (int32_t)(tX - RS.t_start_us) * 0.001f;
+        dlog_s(DL_TRAP_ET, r.name.c_str(), dlog_f(r.at_m), dlog_f(r.et_ms/1000.0f));
+        break;
+      case EK_WIN_B: {
+        et.tB = tX; et.gotB = true;
+        // trap speed (avg di window): ujung window (at_m + w/2) baru saja dilewati
+        float dt = (int32_t)(et.tB - et.tA) * 1e-6f;
+        if (!et.gotA || r.trap_kph > 0 || dt <= 0) break;
+        r.trap_kph = (s_window[ed.trap] / dt) * 3.6f; // m/s -> km/h
+        dlog_s(DL_TRAP_KPH, r.name.c_str(), dlog_f(r.trap_kph));
+        break;
+      }
+    }
+  }
+}
+
+// gating kualitas khusus race: hAcc/sAcc bila ada (UBX), selain itu HDOP
+static bool fix_quality_ok(const GPSFix& fix){
+  if (!fix.valid || fix.fixQ==0) return false;
+  if (fix.hacc_m >= 0) return fix.hacc_m <= G.max_hacc_m && fix.sacc_mps <= G.max_sacc_mps;
+  return fix.hdop <= G.max_hdop_m;
 }
 
 void race_update(const GPSFix& fix){
-  // gating kualitas khusus race
-  if (!fix.valid || fix.hdop > G.max_hdop_m || fix.fixQ==0) return;
+  if (!fix_quality_ok(fix)) return;
 
   // arming otomatis
   float kph = fix.sog_mps * 3.6f;
@@ -147,50 +175,42 @@ void race_update(const GPSFix& fix){
   // start ketika melewati trigger
   if (RS.armed && !RS.running && kph >= G.trigger_speed_kph){
     RS.running = true;
-    RS.t_start_ms = fix.t_ms;
-    RS.lat0 = fix.lat; RS.lon0 = fix.lon;
-    RS.last_lat = fix.lat; RS.last_lon = fix.lon;
+    RS.t_start_us = fix.t_us;
+    RS.lat0_e7 = fix.lat_e7; RS.lon0_e7 = fix.lon_e7;
+    geo_frame_begin(RS.frame, fix.lat_e7, fix.lon_e7);
+    RS.last_e = 0.0f; RS.last_n = 0.0f;
     RS.cum_dist_m = 0.0f;
-    // kosongkan ring buffer
-    rb_head=0; rb_size=0;
-    rb_push({fix.t_ms, 0.0f, fix.sog_mps, fix.lat, fix.lon});
-    logln("[RACE] START");
+    // jejak baru per run
+    s_last = {fix.t_us, 0.0f, fix.sog_mps, fix.lat_e7, fix.lon_e7};
+    trace_reset();
+    trace_push(s_last);
+    s_edge_i = 0;
+    for (auto& et : s_etimes) et = EdgeTimes{0, 0, false, false};
+    dlog(DL_RACE_START);
   }
 
   if (!RS.running) return;
 
   // integrasi jarak path
-  float dstep = (float) hav_m(RS.last_lat, RS.last_lon, fix.lat, fix.lon);
+  float e, n;
+  geo_enu(RS.frame, fix.lat_e7, fix.lon_e7, e, n);
+  float dstep = geo_dist_m(RS.last_e, RS.last_n, e, n);
   // proteksi noise: tolak step terlalu besar dibanding speed (mis-parse)
   float step_max = max(5.0f, fix.sog_mps * 0.3f); // meter per sample
   if (dstep > step_max) dstep = step_max;
 
   RS.cum_dist_m += dstep;
-  RS.last_lat = fix.lat; RS.last_lon = fix.lon;
-
-  rb_push({fix.t_ms, RS.cum_dist_m, fix.sog_mps, fix.lat, fix.lon});
-
-  // cek setiap trap
-  for (size_t i=0; i<RS.results.size(); ++i){
-    auto& r = RS.results[i];
-    if (r.crossed) continue;
-    uint32_t tX=0;
-    if (interp_cross_time(r.at_m, tX)){
-      r.crossed = true;
-      r.t_start_ms = RS.t_start_ms;
-      r.t_cross_ms = tX;
-      r.et_ms = (float)( (int32_t)tX - (int32_t)RS.t_start_ms );
-      // trap speed (avg di window)
-      float w=0;
-      for (auto& tcfg : G.traps) if (tcfg.name==r.name){ w = tcfg.window_m; break; }
-      if (w>0 && window_avg_speed(r.at_m, w, r.trap_kph)){
-        // ok
-      }
-      // log
-      if (w>0)
-        logf("[TRAP] %s @%.1fm ET=%.3fs Trap=%.1f km/h", r.name.c_str(), r.at_m, r.et_ms/1000.0f, r.trap_kph);
-      else
-        logf("[TRAP] %s @%.1fm ET=%.3fs", r.name.c_str(), r.at_m, r.et_ms/1000.0f);
-    }
-  }
+  RS.last_e = e; RS.last_n = n;
+
+  TraceSample now = {fix.t_us, RS.cum_dist_m, fix.sog_mps, fix.lat_e7, fix.lon_e7};
+  trace_push(now);
+  resolve_edges(s_last, now);
+  s_last = now;
+}
+
+bool race_time_at(float dist_m, uint32_t& t_us_out){
+  TraceSample a, b;
+  if (!trace_find_dist(dist_m, a, b)) return false;
+  t_us_out = interp_seg(a, b, dist_m);
+  return true;
 }
@@ -6,6 +6,7 @@
 #include <Arduino.h>
 #include <vector>
 #include "gps_read.h"
+#include "geo.h"
 
 // ===== File lokasi =====
 inline constexpr const char* RACE_PATH = "/config/race.json";
@@ -21,7 +22,9 @@ struct RaceConfig {
   // Start arming/trigger
   float arm_speed_kph      = 1.0f;  // siap start jika kecepatan > ini
   float trigger_speed_kph  = 5.0f;  // mulai timing jika > ini (rising)
-  float max_hdop_m         = 1.5f;  // gating fix
+  float max_hdop_m         = 1.5f;  // gating fix (NMEA)
+  float max_hacc_m         = 2.5f;  // gating fix (UBX hAcc)
+  float max_sacc_mps       = 1.0f;  // gating fix (UBX sAcc)
   // Default daftar traps (drag)
   std::vector<Trap> traps = {
     {"60ft",   18.288f, 2.0f},
@@ -32,8 +35,8 @@ struct RaceConfig {
   };
 };
 
-bool race_load(RaceConfig& out);           // dari SD (isi default jika tidak ada)
-bool race_save(const RaceConfig& cfg);     // ke SD
+bool race_load(RaceConfig& out);           // dari SD via cfgstore (primary/tmp/bak; default jika tidak ada)
+bool race_save(const RaceConfig& cfg);     // antri tulis (write-behind, RAM saja; SD saat idle)
 RaceConfig& race_cfg();                    // akses global
 
 // ===== Runtime race manager =====
@@ -41,8 +44,8 @@ struct TrapResult {
   String name;
   float  at_m;
   bool   crossed;
-  uint32_t t_start_ms;  // waktu start
-  uint32_t t_cross_ms;  // waktu crossing
+  uint32_t t_start_us;  // waktu start (micros, timebase GNSS)
+  uint32_t t_cross_us;  // waktu crossing (micros, timebase GNSS)
   float   et_ms;        // t_cross - t_start (ms)
   float   trap_kph;     // avg speed di window (kalau window_m>0)
 };
@@ -51,9 +54,10 @@ struct RaceState {
   bool armed = false;
   bool running = false;
   uint32_t t_arm_ms = 0;
-  uint32_t t_start_ms = 0;
-  double lat0=0, lon0=0; // titik start
-  double last_lat=0, last_lon=0;
+  uint32_t t_start_us = 0; // epoch fix trigger (GPSFix::t_us)
+  int32_t lat0_e7=0, lon0_e7=0; // titik start (deg * 1e7)
+  GeoFrame frame;        // ENU lokal dengan origin di titik start
+  float  last_e=0, last_n=0; // posisi fix terakhir di frame (m)
   float  cum_dist_m = 0; // jarak dari start (path length)
   std::vector<TrapResult> results;
 };
@@ -63,3 +67,4 @@ void race_arm(bool on);                       // arm/disarm manual
 void race_reset();                            // reset penuh (hasil hilang)
 void race_update(const GPSFix& fix);          // panggil tiap ada fix baru valid
 const RaceState& race_state();                // baca state
+bool race_time_at(float dist_m, uint32_t& t_us_out); // waktu crossing jarak mana pun dari jejak run (post-run)
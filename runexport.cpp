@@ -0,0 +1,186 @@
+/*
+ * File: runexport.cpp
+ * Description: Block-wise reader for run logs and on-the-fly CSV/GPX/VBO converters writing chunked HTTP responses. Generated by AI for clarity.
+ */
+#include "runexport.h"
+#include "runlog.h"
+#include "pipeline.h"
+#include "httpout.h"
+#include "logview.h"
+#include <SD.h>
+#include <rom/crc.h>
+
+static uint8_t s_blk[RUNLOG_BLOCK_BYTES]; // satu blok log / header file
+
+// ===== Format angka dari unit integer (tanpa double) =====
+static const char* fmt_e7(char* d, size_t n, int32_t v){
+  uint32_t a = v < 0 ? 0u - (uint32_t)v : (uint32_t)v;
+  snprintf(d, n, "%s%lu.%07lu", v < 0 ? "-" : "", (unsigned long)(a / 10000000u), (unsigned long)(a % 10000000u));
+  return d;
+}
+// VBO: menit dengan tanda, +MMMMMM.MMMMM
+static const char* fmt_vbo_min(char* d, size_t n, int32_t v){
+  int64_t m5 = (int64_t)v * 6 / 10;  // deg*1e7 -> menit*1e5
+  uint64_t a = m5 < 0 ? (uint64_t)-m5 : (uint64_t)m5;
+  snprintf(d, n, "%c%06llu.%05llu", m5 < 0 ? '-' : '+', (unsigned long long)(a / 100000u), (unsigned long long)(a % 100000u));
+  return d;
+}
+struct Tod { uint32_t h, m, s, ms; };
+static Tod tod(uint32_t gnss_ms){
+  uint32_t t = gnss_ms % 86400000u;  // UBX iTOW -> jam GPS dalam hari
+  return { t / 3600000u, (t / 60000u) % 60u, (t / 1000u) % 60u, t % 1000u };
+}
+
+// ===== Pembaca log =====
+static void run_path(char* d, size_t n, uint16_t id){ snprintf(d, n, "/runs/run_%04u.rbl", (unsigned)id); }
+
+static bool read_hdr(File& f, RunFileHdr& h){
+  if (!f.seek(0) || f.read((uint8_t*)&h, sizeof(h)) != sizeof(h)) return false;
+  return h.magic == RUNLOG_MAGIC_FILE && h.rec_size == sizeof(RunRec) &&
+         h.block_bytes == RUNLOG_BLOCK_BYTES && h.hdr_bytes == RUNLOG_HDR_BYTES;
+}
+
+// Panggil fn(rec) untuk setiap record di blok yang CRC-nya valid; return blok rusak
+template <typename Fn>
+static uint32_t for_each_rec(File& f, const RunFileHdr& h, bool running_only, Fn fn){
+  uint32_t bad = 0;
+  for (uint32_t i = 0; i < h.n_blocks && i < RUNLOG_MAX_BLOCKS; ++i){
+    if (!f.seek(RUNLOG_HDR_BYTES + i * RUNLOG_BLOCK_BYTES) ||
+        f.read(s_blk, RUNLOG_BLOCK_BYTES) != RUNLOG_BLOCK_BYTES){ bad++; break; }
+    const RunBlockHdr& bh = *(const RunBlockHdr*)s_blk;
+    const RunRec* r = (const RunRec*)(s_blk + sizeof(RunBlockHdr));
+    if (bh.magic != RUNLOG_MAGIC_BLOCK || bh.n > RUNLOG_RECS_PER_BLOCK ||
+        bh.crc32 != crc32_le(0, (const uint8_t*)r, bh.n * sizeof(RunRec))){ bad++; continue; }
+    for (uint16_t k = 0; k < bh.n; ++k){
+      if (running_only && !(r[k].flags & RLF_RUNNING)) continue;
+      fn(r[k]);
+    }
+    pipeline_poll();
+  }
+  return bad;
+}
+
+// ===== Konverter =====
+static void rec_csv(const RunRec& r){
+  char la[16], lo[16];
+  Tod t = tod(r.gnss_ms);
+  char hacc[12] = "";
+  if (r.hacc_cm != 0xFFFF) snprintf(hacc, sizeof(hacc), "%.2f", r.hacc_cm * 0.01f);
+  http_out_printf("%lu,%02lu:%02lu:%02lu.%03lu,%s,%s,%.1f,%.2f,%.2f,%.1f,%s,%u,%u,%u,%.3f\n",
+             (unsigned long)r.t_us, (unsigned long)t.h, (unsigned long)t.m, (unsigned long)t.s, (unsigned long)t.ms,
+             fmt_e7(la, sizeof(la), r.lat_e7), fmt_e7(lo, sizeof(lo), r.lon_e7),
+             r.alt_dm * 0.1f, r.sog_cms * 0.036f, r.cog_cdeg * 0.01f, r.hdop_d * 0.1f, hacc,
+             (unsigned)r.sv, (unsigned)r.fixQ, (unsigned)r.flags, r.dist_mm * 0.001f);
+}
+
+static void rec_gpx(const RunRec& r){
+  if (!(r.flags & RLF_VALID)) return;  // trkpt butuh posisi valid
+  char la[16], lo[16];
+  http_out_printf("<trkpt lat=\"%s\" lon=\"%s\"><ele>%.1f</ele><course>%.2f</course><speed>%.2f</speed>"
+             "<sat>%u</sat><hdop>%.1f</hdop></trkpt>\n",
+             fmt_e7(la, sizeof(la), r.lat_e7), fmt_e7(lo, sizeof(lo), r.lon_e7), r.alt_dm * 0.1f,
+             r.cog_cdeg * 0.01f, r.sog_cms * 0.01f, (unsigned)r.sv, r.hdop_d * 0.1f);
+}
+
+static void rec_vbo(const RunRec& r){
+  if (!(r.flags & RLF_VALID)) return;
+  char la[20], lo[20];
+  Tod t = tod(r.gnss_ms);
+  // VBO: bujur positif = barat
+  http_out_printf("%03u %02lu%02lu%02lu.%02lu %s %s %07.3f %06.2f %+09.2f\n",
+             (unsigned)r.sv, (unsigned long)t.h, (unsigned long)t.m, (unsigned long)t.s, (unsigned long)(t.ms / 10),
+             fmt_vbo_min(la, sizeof(la), r.lat_e7), fmt_vbo_min(lo, sizeof(lo), -r.lon_e7),
+             r.sog_cms * 0.036f, r.cog_cdeg * 0.01f, r.alt_dm * 0.1f);
+}
+
+bool runexport_parse(const String& name, uint16_t& id, RunFmt& fmt){
+  const char* n = name.c_str();
+  const char* dot = strrchr(n, '.');
+  if (!dot || dot == n) return false;
+  if      (!strcmp(dot + 1, "csv")) fmt = RF_CSV;
+  else if (!strcmp(dot + 1, "gpx")) fmt = RF_GPX;
+  else if (!strcmp(dot + 1, "vbo")) fmt = RF_VBO;
+  else return false;
+  char* end = nullptr;
+  unsigned long v = strtoul(n, &end, 10);
+  if (end != dot || v == 0 || v > 9999) return false;
+  id = (uint16_t)v;
+  return true;
+}
+
+bool runexport_send(WebServer& srv, uint16_t id, RunFmt fmt, bool running_only){
+  char path[32];
+  run_path(path, sizeof(path), id);
+  File f = SD.open(path, FILE_READ);
+  if (!f) return false;
+  RunFileHdr h;
+  if (!read_hdr(f, h)){ f.close(); return false; }
+
+  static const char* const EXT[]  = {"csv", "gpx", "vbo"};
+  static const char* const TYPE[] = {"text/csv", "application/gpx+xml", "text/plain"};
+  char fname[24];
+  snprintf(fname, sizeof(fname), "run_%04u.%s", (unsigned)id, EXT[fmt]);
+  http_out_begin(srv, TYPE[fmt], fname);
+
+  uint32_t bad = 0;
+  switch (fmt){
+    case RF_CSV:
+      http_out_printf("t_us,time,lat,lon,alt_m,speed_kph,heading_deg,hdop,hacc_m,sats,fixq,flags,dist_m\n");
+      bad = for_each_rec(f, h, running_only, rec_csv);
+      break;
+    case RF_GPX:
+      http_out_printf("<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+                 "<gpx version=\"1.0\" creator=\"RaceBox\" xmlns=\"http://www.topografix.com/GPX/1/0\">\n"
+                 "<trk><name>run_%04u</name><trkseg>\n", (unsigned)id);
+      bad = for_each_rec(f, h, running_only, rec_gpx);
+      http_out_printf("</trkseg></trk></gpx>\n");
+      break;
+    case RF_VBO:
+      // waktu = jam GNSS dalam hari (UTC untuk NMEA, jam GPS untuk UBX iTOW)
+      http_out_printf("File created by RaceBox run_%04u\r\n\r\n", (unsigned)id);
+      {
+        static const char HDR[] =
+          "[header]\r\nsatellites\r\ntime\r\nlatitude\r\nlongitude\r\nvelocity kmh\r\nheading\r\n"
+          "height\r\n\r\n[column names]\r\nsats time lat long velocity heading height\r\n\r\n[data]\r\n";
+        http_out_write(HDR, sizeof(HDR) - 1);
+      }
+      bad = for_each_rec(f, h, running_only, rec_vbo);
+      break;
+  }
+  http_out_end();
+  f.close();
+  if (bad) logf("[EXPORT] %s: %lu bad block(s) skipped", path, (unsigned long)bad);
+  return true;
+}
+
+void runexport_list(WebServer& srv){
+  http_out_begin(srv, "application/json", nullptr);
+  http_out_printf("[");
+  File dir = SD.open("/runs");
+  bool first = true;
+  if (dir && dir.isDirectory()){
+    for (File e = dir.openNextFile(); e; e = dir.openNextFile()){
+      unsigned id = 0;
+      const char* nm = strrchr(e.name(), '/');
+      nm = nm ? nm + 1 : e.name();
+      RunFileHdr h;
+      if (sscanf(nm, "run_%u.rbl", &id) == 1 && read_hdr(e, h)){
+        // jumlah record dari indeks header (tanpa membaca blok data)
+        uint32_t recs = 0, running = 0;
+        const uint32_t nb = min<uint32_t>(h.n_blocks, RUNLOG_MAX_BLOCKS);
+        if (e.seek(sizeof(RunFileHdr)) && e.read(s_blk, nb * sizeof(RunIndex)) == nb * sizeof(RunIndex)){
+          const RunIndex* ix = (const RunIndex*)s_blk;
+          for (uint32_t i = 0; i < nb; ++i){ recs += ix[i].n; if (ix[i].flags & RLF_RUNNING) running++; }
+        }
+        http_out_printf("%s{\"id\":%u,\"blocks\":%lu,\"recs\":%lu,\"running_blocks\":%lu,\"bytes\":%lu}",
+                   first ? "" : ",", id, (unsigned long)nb, (unsigned long)recs, (unsigned long)running,
+                   (unsigned long)e.size());
+        first = false;
+      }
+      e.close();
+    }
+    dir.close();
+  }
+  http_out_printf("]");
+  http_out_end();
+}
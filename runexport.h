@@ -0,0 +1,22 @@
+/*
+ * File: runexport.h
+ * Description: Streams stored binary run logs over HTTP as CSV, GPX or VBO using chunked transfer and a fixed buffer. Generated by AI for clarity.
+ */
+#pragma once
+/* Export run log (/runs/run_NNNN.rbl, lihat runlog.h) lewat HTTP.
+   - Dibaca per blok 4 KB (CRC dicek, blok rusak dilewati), dikonversi per record
+     ke buffer keluaran ~1 segmen TCP, dikirim sebagai chunk (Transfer-Encoding: chunked).
+   - Tidak ada String/JsonDocument sebesar run; RAM tetap berapapun panjang sesi.
+   - Di sela chunk pipeline_poll() dipanggil supaya fix tetap diproses walau download
+     panjang berjalan di loop() (mode single loop). */
+#include <Arduino.h>
+#include <WebServer.h>
+
+enum RunFmt : uint8_t { RF_CSV, RF_GPX, RF_VBO };
+
+// "0003.csv" -> id=3, fmt=RF_CSV. false bila format tidak dikenal
+bool runexport_parse(const String& name, uint16_t& id, RunFmt& fmt);
+// GET /api/runs: daftar file (JSON, streaming)
+void runexport_list(WebServer& srv);
+// GET /api/runs/<id>.<fmt>; running_only = hanya record saat race running. false bila file tidak ada
+bool runexport_send(WebServer& srv, uint16_t id, RunFmt fmt, bool running_only);
@@ -0,0 +1,186 @@
+/*
+ * File: runlog.cpp
+ * Description: Run logger: two RAM blocks filled by the race owner, flushed by a low-priority task into a preallocated SD file. Generated by AI for clarity.
+ */
+#include "runlog.h"
+#include "global.h"
+#include "logview.h"
+#include <atomic>
+#include <rom/crc.h>  // crc32_le (CRC-32 IEEE di ROM)
+
+struct Block { RunBlockHdr h; RunRec r[RUNLOG_RECS_PER_BLOCK]; };
+static_assert(sizeof(Block) == RUNLOG_BLOCK_BYTES, "Block harus tepat satu blok file");
+
+enum BlkState : uint8_t { BS_FREE, BS_FULL };
+
+// ===== Sisi producer (pemilik race engine) =====
+static Block s_blk[2];
+static std::atomic<uint8_t> s_state[2];
+static uint8_t  s_fill = 0;          // blok yang sedang diisi
+static bool     s_prev_running = false, s_prev_done = false;
+static TaskHandle_t s_task = nullptr;
+static RunLogStats ST{};             // recs/dropped: producer; sisanya: task logger
+
+// ===== Sisi task logger =====
+static constexpr uint32_t RUNLOG_IDLE_MS        = 200; // tanpa blok penuh: langkah prealloc
+static constexpr uint32_t RUNLOG_PREALLOC_INIT  = 8;   // blok dialokasikan saat file dibuka
+static constexpr uint32_t RUNLOG_PREALLOC_AHEAD = 64;  // jaga alokasi sejauh ini di depan tulis
+static const char* RUNLOG_DIR = "/runs";
+
+union FileHdr {
+  struct { RunFileHdr h; RunIndex idx[RUNLOG_MAX_BLOCKS]; } s;
+  uint8_t raw[RUNLOG_HDR_BYTES];
+};
+static FileHdr  s_hdr;
+static File     s_f;
+static uint32_t s_flush = 0;         // blok berikutnya untuk ditulis (urutan = urutan isi)
+static uint8_t  s_zero[512];
+
+static void hand_over(){
+  s_state[s_fill].store(BS_FULL, std::memory_order_release);
+  s_fill ^= 1;
+  xTaskNotifyGive(s_task);
+}
+
+void runlog_append(const GPSFix& fix, const RaceState& rs){
+  if (!s_task) return;
+  ST.recs++;
+  Block& b = s_blk[s_fill];
+  // blok ini masih ditulis task logger (SD macet) -> buang, jangan pernah menunggu
+  if (s_state[s_fill].load(std::memory_order_acquire) != BS_FREE){ ST.dropped++; return; }
+
+  RunRec& r = b.r[b.h.n++];
+  r.t_us    = fix.t_us;
+  r.gnss_ms = fix.gnss_ms;
+  r.lat_e7  = fix.lat_e7;
+  r.lon_e7  = fix.lon_e7;
+  r.dist_mm = rs.running ? (uint32_t)lroundf(rs.cum_dist_m * 1000.0f) : 0;
+  r.sog_cms = (uint16_t)constrain(lroundf(fix.sog_mps * 100.0f), 0L, 65535L);
+  r.cog_cdeg= (uint16_t)(constrain(lroundf(fix.cog_deg * 100.0f), 0L, 35999L));
+  r.alt_dm  = (int16_t)constrain(lroundf(fix.alt_m * 10.0f), -32768L, 32767L);
+  r.hacc_cm = (fix.hacc_m < 0) ? 0xFFFF : (uint16_t)constrain(lroundf(fix.hacc_m * 100.0f), 0L, 65534L);
+  r.hdop_d  = (uint8_t)constrain(lroundf(fix.hdop * 10.0f), 0L, 255L);
+  r.fixQ    = fix.fixQ;
+  r.sv      = fix.sv;
+  r.flags   = (fix.valid ? RLF_VALID : 0) | (rs.armed ? RLF_ARMED : 0) | (rs.running ? RLF_RUNNING : 0);
+
+  // run mulai/selesai (semua trap lewat): tulis blok parsial supaya run cepat ada di SD
+  bool done = rs.running && !rs.results.empty();
+  for (auto& t : rs.results) if (!t.crossed){ done = false; break; }
+  bool edge = (rs.running != s_prev_running) || (done && !s_prev_done);
+  s_prev_running = rs.running; s_prev_done = done;
+
+  if (b.h.n >= RUNLOG_RECS_PER_BLOCK || edge) hand_over();
+}
+
+void runlog_sync(){
+  if (s_task && s_blk[s_fill].h.n > 0 &&
+      s_state[s_fill].load(std::memory_order_acquire) == BS_FREE) hand_over();
+}
+
+RunLogStats runlog_stats(){ return ST; }
+
+// ===== Task logger =====
+static uint32_t blk_off(uint32_t i){ return RUNLOG_HDR_BYTES + i * RUNLOG_BLOCK_BYTES; }
+
+static bool write_at(uint32_t off, const void* p, size_t n){
+  return s_f.seek(off) && s_f.write((const uint8_t*)p, n) == n;
+}
+
+// Tambah satu blok nol di ujung file (alokasi cluster di muka)
+static bool prealloc_one(){
+  RunFileHdr& h = s_hdr.s.h;
+  if (!s_f || h.alloc_blocks >= RUNLOG_MAX_BLOCKS) return false;
+  if (!s_f.seek(blk_off(h.alloc_blocks))) return false;
+  for (size_t i = 0; i < RUNLOG_BLOCK_BYTES / sizeof(s_zero); ++i)
+    if (s_f.write(s_zero, sizeof(s_zero)) != sizeof(s_zero)) return false;
+  h.alloc_blocks++;
+  return true;
+}
+
+static void close_file(){
+  if (!s_f) return;
+  write_at(0, s_hdr.raw, RUNLOG_HDR_BYTES);
+  s_f.close();
+}
+
+static bool open_next_file(){
+  close_file();
+  if (!SD.exists(RUNLOG_DIR)) SD.mkdir(RUNLOG_DIR);
+  char path[32];
+  uint16_t no = ST.file_no;
+  do {
+    if (++no > 9999) return false;
+    snprintf(path, sizeof(path), "%s/run_%04u.rbl", RUNLOG_DIR, (unsigned)no);
+  } while (SD.exists(path));
+  s_f = SD.open(path, FILE_WRITE);
+  if (!s_f) { logf("[RUNLOG] Open %s FAILED", path); return false; }
+
+  memset(s_hdr.raw, 0, sizeof(s_hdr.raw));
+  RunFileHdr& h = s_hdr.s.h;
+  h.magic = RUNLOG_MAGIC_FILE; h.version = RUNLOG_VERSION;
+  h.rec_size = sizeof(RunRec); h.block_bytes = RUNLOG_BLOCK_BYTES; h.hdr_bytes = RUNLOG_HDR_BYTES;
+  if (!write_at(0, s_hdr.raw, RUNLOG_HDR_BYTES)) { s_f.close(); return false; }
+  for (uint32_t i = 0; i < RUNLOG_PREALLOC_INIT; ++i) prealloc_one();
+  s_f.flush();
+  ST.file_no = no;
+  logf("[RUNLOG] %s", path);
+  return true;
+}
+
+static void flush_block(Block& b){
+  RunFileHdr& h = s_hdr.s.h;
+  if (s_f && h.n_blocks >= RUNLOG_MAX_BLOCKS) open_next_file();
+  if (!s_f && !open_next_file()) { ST.write_err++; return; }
+
+  uint32_t t0 = micros();
+  const uint32_t i = h.n_blocks;
+  b.h.magic = RUNLOG_MAGIC_BLOCK;
+  b.h.seq = i;
+  b.h.rec_size = sizeof(RunRec);
+  b.h.crc32 = crc32_le(0, (const uint8_t*)b.r, b.h.n * sizeof(RunRec));
+  uint8_t fl = 0;
+  for (uint16_t k = 0; k < b.h.n; ++k) fl |= b.r[k].flags;
+
+  // blok di offset tetap; setelah itu sektor header + sektor indeks yang berubah
+  bool ok = write_at(blk_off(i), &b, RUNLOG_BLOCK_BYTES);
+  if (ok){
+    s_hdr.s.idx[i] = RunIndex{b.r[0].gnss_ms, b.h.n, fl, 0};
+    h.n_blocks = i + 1;
+    if (h.alloc_blocks < h.n_blocks) h.alloc_blocks = h.n_blocks;
+    size_t sec = (size_t)((const uint8_t*)&s_hdr.s.idx[i] - s_hdr.raw) / 512;
+    ok = write_at(0, s_hdr.raw, 512);
+    if (ok && sec) ok = write_at(sec * 512, s_hdr.raw + sec * 512, 512);
+    s_f.flush();
+  }
+  if (ok) ST.blocks++; else ST.write_err++;
+  uint32_t dt = micros() - t0;
+  if (dt > ST.flush_us_max) ST.flush_us_max = dt;
+}
+
+static void runlog_task(void*){
+  open_next_file();
+  for (;;){
+    ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(RUNLOG_IDLE_MS));
+    while (s_state[s_flush].load(std::memory_order_acquire) == BS_FULL){
+      flush_block(s_blk[s_flush]);
+      s_blk[s_flush].h.n = 0;
+      s_state[s_flush].store(BS_FREE, std::memory_order_release);
+      s_flush ^= 1;
+    }
+    // idle: jaga alokasi di depan posisi tulis
+    const RunFileHdr& h = s_hdr.s.h;
+    if (s_f && h.alloc_blocks < h.n_blocks + RUNLOG_PREALLOC_AHEAD && prealloc_one()) s_f.flush();
+  }
+}
+
+bool runlog_begin(){
+  if (s_task) return true;
+  if (SD.cardType() == CARD_NONE){ logln("[RUNLOG] No SD, logger off"); return false; }
+  s_state[0].store(BS_FREE); s_state[1].store(BS_FREE);
+  BaseType_t ok = xTaskCreatePinnedToCore(runlog_task, "runlog", RUNLOG_STACK,
+                                          nullptr, RUNLOG_PRIO, &s_task, RUNLOG_CORE);
+  if (ok != pdPASS){ s_task = nullptr; logln("[RUNLOG] Task create FAILED"); return false; }
+  logf("[RUNLOG] Logger task on core %d, prio %d", (int)RUNLOG_CORE, (int)RUNLOG_PRIO);
+  return true;
+}
@@ -0,0 +1,89 @@
+/*
+ * File: runlog.h
+ * Description: Double-buffered binary fix logger to SD; appends never block, full blocks flush from a background task. Generated by AI for clarity.
+ */
+#pragma once
+/* Run logger biner.
+   - Pemilik race engine memanggil runlog_append() tiap fix: hanya memcpy 32 byte ke
+     blok RAM aktif (dua blok, bergantian). Tidak pernah menyentuh SD.
+   - Blok penuh diserahkan ke task logger prioritas rendah yang menulisnya ke file
+     /runs/run_NNNN.rbl dalam write 4096 byte (kelipatan sektor 512) di offset tetap.
+   - File dialokasikan di muka (zero-fill bertahap saat idle) supaya cluster FAT
+     berurutan dan flush tidak pernah menunggu alokasi.
+   - Tiap blok ber-CRC32; header file (4096 byte) memuat indeks blok.
+   Bila kedua blok penuh karena SD lambat, record dibuang & dihitung (dropped). */
+#include <Arduino.h>
+#include "gps_read.h"
+#include "race.h"
+
+// ===== Format file =====
+inline constexpr uint32_t RUNLOG_MAGIC_FILE  = 0x314C4252; // "RBL1"
+inline constexpr uint32_t RUNLOG_MAGIC_BLOCK = 0x4B4C4252; // "RBLK"
+inline constexpr uint16_t RUNLOG_VERSION     = 1;
+inline constexpr size_t   RUNLOG_BLOCK_BYTES = 4096;       // blok data = 8 sektor
+inline constexpr size_t   RUNLOG_HDR_BYTES   = 4096;       // header file + indeks
+
+enum : uint8_t {
+  RLF_VALID   = 1 << 0,
+  RLF_ARMED   = 1 << 1,
+  RLF_RUNNING = 1 << 2,
+};
+
+// Satu fix (32 byte, little-endian, unit integer)
+struct __attribute__((packed)) RunRec {
+  uint32_t t_us;      // epoch pengukuran (micros, timebase GNSS)
+  uint32_t gnss_ms;   // waktu GNSS (ms dari tengah malam / iTOW)
+  int32_t  lat_e7, lon_e7;
+  uint32_t dist_mm;   // jarak race dari start (0 bila belum running)
+  uint16_t sog_cms;
+  uint16_t cog_cdeg;
+  int16_t  alt_dm;
+  uint16_t hacc_cm;   // 0xFFFF = tidak ada (NMEA)
+  uint8_t  hdop_d;    // HDOP * 10
+  uint8_t  fixQ, sv;
+  uint8_t  flags;     // RLF_*
+};
+static_assert(sizeof(RunRec) == 32, "RunRec harus 32 byte");
+
+struct __attribute__((packed)) RunBlockHdr {
+  uint32_t magic;     // RUNLOG_MAGIC_BLOCK
+  uint32_t seq;       // nomor blok dalam file
+  uint16_t n;         // record terisi (blok parsial saat sync)
+  uint16_t rec_size;
+  uint32_t crc32;     // CRC32 record[0..n)
+  uint8_t  rsv[16];
+};
+inline constexpr size_t RUNLOG_RECS_PER_BLOCK = (RUNLOG_BLOCK_BYTES - sizeof(RunBlockHdr)) / sizeof(RunRec); // 127
+
+struct __attribute__((packed)) RunIndex {
+  uint32_t gnss_ms;   // record pertama blok
+  uint16_t n;
+  uint8_t  flags;     // OR flags semua record (cari blok yang berisi run)
+  uint8_t  rsv;
+};
+
+struct __attribute__((packed)) RunFileHdr {
+  uint32_t magic;     // RUNLOG_MAGIC_FILE
+  uint16_t version;
+  uint16_t rec_size;
+  uint16_t block_bytes;
+  uint16_t hdr_bytes;
+  uint32_t n_blocks;  // blok valid setelah header
+  uint32_t alloc_blocks;
+  uint8_t  rsv[12];
+};
+inline constexpr size_t RUNLOG_MAX_BLOCKS = (RUNLOG_HDR_BYTES - sizeof(RunFileHdr)) / sizeof(RunIndex); // 508 (~53 menit @20 Hz)
+
+struct RunLogStats {
+  uint32_t recs;          // record diterima
+  uint32_t dropped;       // dibuang (dua blok penuh / SD tidak siap)
+  uint32_t blocks;        // blok tertulis (semua file)
+  uint32_t write_err;
+  uint32_t flush_us_max;  // write blok terlama (di task logger, bukan jalur timing)
+  uint16_t file_no;       // run_NNNN.rbl aktif (0 = belum ada)
+};
+
+bool runlog_begin();                                 // setelah SD siap; start task logger
+void runlog_append(const GPSFix& fix, const RaceState& rs);  // dari pemilik race engine
+void runlog_sync();                                  // serahkan blok parsial untuk ditulis
+RunLogStats runlog_stats();
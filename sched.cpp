@@ -0,0 +1,89 @@
+/*
+ * File: sched.cpp
+ * Description: Job table, priority/deadline selection and sleep-until-next-due for the loop scheduler. Generated by AI for clarity.
+ */
+#include "sched.h"
+#include "perf.h"
+
+struct Job {
+  SchedFn  fn;
+  uint32_t period_ms, deadline_ms;
+  uint32_t due_ms;
+  uint8_t  prio;
+  bool     on_event;
+  SchedStats st;
+};
+
+static Job      s_jobs[SCHED_MAX_JOBS];
+static uint8_t  s_n = 0;
+static bool   (*s_wait)(uint32_t) = nullptr;
+static uint32_t s_sleep_ms = 0;
+
+static inline bool is_due(const Job& j, uint32_t now){ return (int32_t)(now - j.due_ms) >= 0; }
+
+uint8_t sched_add(const char* name, SchedFn fn, uint32_t period_ms, uint8_t prio,
+                  uint32_t deadline_ms, bool on_event){
+  if (s_n >= SCHED_MAX_JOBS || !fn) return 0xFF;
+  Job& j = s_jobs[s_n];
+  j.fn = fn; j.period_ms = max<uint32_t>(period_ms, 1); j.deadline_ms = deadline_ms;
+  j.due_ms = millis(); j.prio = prio; j.on_event = on_event;
+  j.st = SchedStats{name, 0, 0, 0};
+  return s_n++;
+}
+
+void sched_kick(uint8_t id){ if (id < s_n) s_jobs[id].due_ms = millis(); }
+void sched_set_wait(bool (*wait)(uint32_t)){ s_wait = wait; }
+
+// Job jatuh tempo paling mendesak: prioritas, lalu deadline absolut
+static int pick(uint32_t now, uint32_t skip){
+  int best = -1;
+  for (uint8_t i = 0; i < s_n; ++i){
+    const Job& j = s_jobs[i];
+    if ((skip & (1u << i)) || !is_due(j, now)) continue;
+    if (best < 0) { best = i; continue; }
+    const Job& b = s_jobs[best];
+    if (j.prio != b.prio){ if (j.prio > b.prio) best = i; continue; }
+    if ((int32_t)((j.due_ms + j.deadline_ms) - (b.due_ms + b.deadline_ms)) < 0) best = i;
+  }
+  return best;
+}
+
+static void run_due(){
+  PERF_SCOPE(PS_LOOP);
+  // tiap job maks sekali per putaran: job yang minta 0 ms tidak bisa memonopoli loop
+  uint32_t ran = 0;
+  for (;;){
+    uint32_t now = millis();
+    int i = pick(now, ran);
+    if (i < 0) break;
+    Job& j = s_jobs[i];
+    uint32_t late = now - j.due_ms;
+    if (late > j.deadline_ms) j.st.late++;
+    if (late > j.st.max_late_ms) j.st.max_late_ms = late;
+    uint32_t next = j.fn();
+    j.st.runs++;
+    j.due_ms = millis() + ((next == SCHED_PERIOD) ? j.period_ms : next);
+    ran |= 1u << i;
+  }
+}
+
+void sched_run(){
+  run_due();
+
+  // tidur sampai job terdekat (atau event)
+  uint32_t now = millis(), wait = SCHED_MAX_SLEEP_MS;
+  for (uint8_t i = 0; i < s_n; ++i){
+    int32_t d = (int32_t)(s_jobs[i].due_ms - now);
+    if (d <= 0) return;                      // sudah jatuh tempo lagi: putaran berikutnya
+    if ((uint32_t)d < wait) wait = (uint32_t)d;
+  }
+  bool ev;
+  if (s_wait) ev = s_wait(wait);
+  else { delay(wait); ev = false; }
+  s_sleep_ms += millis() - now;
+  if (ev) for (uint8_t i = 0; i < s_n; ++i) if (s_jobs[i].on_event) s_jobs[i].due_ms = millis();
+}
+
+uint8_t sched_count(){ return s_n; }
+SchedStats sched_stats(uint8_t id){ return (id < s_n) ? s_jobs[id].st : SchedStats{"?", 0, 0, 0}; }
+uint32_t sched_sleep_ms(){ return s_sleep_ms; }
@@ -0,0 +1,41 @@
+/*
+ * File: sched.h
+ * Description: Small cooperative deadline scheduler for loop(): periodic jobs with priority, deadline and event wake-up. Generated by AI for clarity.
+ */
+#pragma once
+/* Scheduler kooperatif untuk loop():
+   - Tiap subsistem daftar sekali: periode, prioritas, deadline (toleransi telat).
+   - sched_run() menjalankan job yang jatuh tempo satu per satu: prioritas tertinggi
+     dulu, seri -> deadline absolut paling awal. Setelah tiap job dipilih ulang, jadi
+     GPS yang jatuh tempo tidak menunggu semua job lain.
+   - Job boleh mengembalikan jeda ke run berikutnya (mis. lv_timer_handler()), atau
+     SCHED_PERIOD untuk periode tetap.
+   - Tidak ada yang jatuh tempo: task tidur sampai job terdekat atau event (hook wait,
+     mis. burst UART GPS) yang langsung menandai job on_event jatuh tempo.
+   Non-preemptif: latency GPS dibatasi durasi job terpanjang yang sedang jalan. */
+#include <Arduino.h>
+
+inline constexpr uint32_t SCHED_PERIOD   = 0xFFFFFFFFu; // return job: pakai periode terdaftar
+inline constexpr uint8_t  SCHED_MAX_JOBS = 8;
+inline constexpr uint32_t SCHED_MAX_SLEEP_MS = 50;      // batas tidur (jaga respons watchdog/log)
+
+typedef uint32_t (*SchedFn)();
+
+struct SchedStats {
+  const char* name;
+  uint32_t runs;
+  uint32_t late;         // mulai setelah due + deadline
+  uint32_t max_late_ms;  // keterlambatan mulai terbesar (ms setelah due)
+};
+
+// Return id job (0..), atau 0xFF bila tabel penuh
+uint8_t sched_add(const char* name, SchedFn fn, uint32_t period_ms, uint8_t prio,
+                  uint32_t deadline_ms, bool on_event = false);
+
+void sched_kick(uint8_t id);                    // jatuh tempo sekarang (task yang sama)
+void sched_set_wait(bool (*wait)(uint32_t ms)); // tidur sampai ms / event; true = event
+void sched_run();                               // satu putaran loop()
+
+uint8_t sched_count();
+SchedStats sched_stats(uint8_t id);
+uint32_t sched_sleep_ms();                      // total waktu tidur sejak boot
@@ -0,0 +1,138 @@
+/*
+ * File: spsc_ring.h
+ * Description: Lock-free single-producer/single-consumer ring and latest-value slot for passing data between cores. Generated by AI for clarity.
+ */
+#pragma once
+/* Ring SPSC tanpa lock: satu task menulis (push), satu task membaca (pop).
+   Index head/tail atomic; slot disalin by value, jadi T harus trivially copyable.
+   Kapasitas N harus pangkat 2; satu slot selalu kosong untuk membedakan penuh/kosong. */
+#include <Arduino.h>
+#include <atomic>
+#include <type_traits>
+
+template <typename T, uint32_t N>
+class SpscRing {
+  static_assert(N >= 2 && (N & (N - 1)) == 0, "SpscRing: N harus pangkat 2");
+  static_assert(std::is_trivially_copyable<T>::value, "SpscRing: T harus trivially copyable");
+
+public:
+  // Producer. false jika penuh (item dibuang, dihitung di dropped())
+  bool push(const T& v) {
+    const uint32_t h = head_.load(std::memory_order_relaxed);
+    const uint32_t next = (h + 1) & (N - 1);
+    if (next == tail_.load(std::memory_order_acquire)) { dropped_++; return false; }
+    buf_[h] = v;
+    head_.store(next, std::memory_order_release);
+    return true;
+  }
+
+  // Consumer. false jika kosong
+  bool pop(T& out) {
+    const uint32_t t = tail_.load(std::memory_order_relaxed);
+    if (t == head_.load(std::memory_order_acquire)) return false;
+    out = buf_[t];
+    tail_.store((t + 1) & (N - 1), std::memory_order_release);
+    return true;
+  }
+
+  // Consumer: buang semua kecuali item terbaru. false jika kosong
+  bool pop_latest(T& out) {
+    bool any = false;
+    while (pop(out)) any = true;
+    return any;
+  }
+
+  bool empty() const { return tail_.load(std::memory_order_relaxed) == head_.load(std::memory_order_acquire); }
+  uint32_t dropped() const { return dropped_; }  // dibaca producer / untuk statistik
+
+private:
+  T buf_[N];
+  std::atomic<uint32_t> head_{0};
+  std::atomic<uint32_t> tail_{0};
+  uint32_t dropped_ = 0;
+};
+
+/* Slot "state terbaru" satu producer / satu consumer (seqlock double buffer).
+   Berbeda dengan SpscRing, producer tidak pernah gagal: snapshot yang belum dibaca
+   ditimpa yang lebih baru, jadi konsumen yang telat tetap melihat epoch terakhir.
+   Consumer mengulang salinan bila producer sempat menimpa slot yang sedang dibaca
+   (butuh dua publish selama satu salinan; praktis tidak terjadi di 20-25 Hz). */
+template <typename T>
+class SpscLatest {
+  static_assert(std::is_trivially_copyable<T>::value, "SpscLatest: T harus trivially copyable");
+
+public:
+  // Producer: tulis ke slot yang tidak sedang dipublikasikan, lalu naikkan seq
+  void publish(const T& v) {
+    const uint32_t w = seq_.load(std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);  // seq lama terlihat sebelum isi slot berubah
+    buf_[(w + 1) & 1] = v;
+    seq_.store(w + 1, std::memory_order_release);
+  }
+
+  // Consumer: salin snapshot terbaru ke out. false (out tidak disentuh) jika tidak ada yang baru
+  bool read_latest(T& out) {
+    for (;;) {
+      const uint32_t w = seq_.load(std::memory_order_acquire);
+      if (w == read_) return false;
+      out = buf_[w & 1];
+      std::atomic_thread_fence(std::memory_order_acquire);
+      if (seq_.load(std::memory_order_relaxed) != w) continue;  // slot tertimpa saat disalin
+      skipped_ += w - read_ - 1;
+      read_ = w;
+      return true;
+    }
+  }
+
+  uint32_t skipped() const { return skipped_; }  // publish yang ditimpa sebelum dibaca (sisi consumer)
+
+private:
+  T buf_[2];
+  std::atomic<uint32_t> seq_{0};
+  uint32_t read_ = 0;
+  uint32_t skipped_ = 0;
+};
+
+/* Varian byte untuk stream (mis. UART): write/read bulk dengan memcpy.
+   Posisi head/tail berjalan bebas (uint32 wrap), index = pos & (N-1), sehingga
+   posisi absolut bisa dipakai sebagai penanda batas burst. */
+template <uint32_t N>
+class SpscBytes {
+  static_assert(N >= 2 && (N & (N - 1)) == 0, "SpscBytes: N harus pangkat 2");
+
+public:
+  // Producer. Return jumlah byte yang masuk (< n jika ring penuh)
+  size_t write(const uint8_t* src, size_t n) {
+    const uint32_t h = head_.load(std::memory_order_relaxed);
+    const uint32_t free_n = N - (h - tail_.load(std::memory_order_acquire));
+    if (n > free_n) n = free_n;
+    const uint32_t i = h & (N - 1);
+    const size_t first = std::min<size_t>(n, N - i);
+    memcpy(buf_ + i, src, first);
+    memcpy(buf_, src + first, n - first);
+    head_.store(h + (uint32_t)n, std::memory_order_release);
+    return n;
+  }
+
+  // Consumer. Ambil maksimal n byte, tapi tidak melewati posisi absolut limit
+  size_t read(uint8_t* dst, size_t n, uint32_t limit) {
+    const uint32_t t = tail_.load(std::memory_order_relaxed);
+    const uint32_t avail = std::min<uint32_t>(head_.load(std::memory_order_acquire) - t, limit - t);
+    if (n > avail) n = avail;
+    const uint32_t i = t & (N - 1);
+    const size_t first = std::min<size_t>(n, N - i);
+    memcpy(dst, buf_ + i, first);
+    memcpy(dst + first, buf_, n - first);
+    tail_.store(t + (uint32_t)n, std::memory_order_release);
+    return n;
+  }
+
+  uint32_t head() const { return head_.load(std::memory_order_acquire); }  // posisi tulis absolut
+  uint32_t tail() const { return tail_.load(std::memory_order_acquire); }  // posisi baca absolut
+  uint32_t size() const { return head() - tail(); }
+
+private:
+  uint8_t buf_[N];
+  std::atomic<uint32_t> head_{0};
+  std::atomic<uint32_t> tail_{0};
+};
@@ -0,0 +1,148 @@
+/*
+ * File: timebase.cpp
+ * Description: Lower-envelope fit of GNSS time against micros() for sub-millisecond fix stamping. Generated by AI for clarity.
+ */
+#include "timebase.h"
+#include <algorithm>  // std::min
+
+// Residual minimum per bucket 2 s, simpan ~32 s terakhir
+static constexpr uint8_t  TB_BUCKETS     = 16;
+static constexpr uint32_t TB_BUCKET_MS   = 2000;
+static constexpr uint8_t  TB_OFFSET_BKTS = 4;       // envelope offset dari ~8 s terakhir
+static constexpr uint32_t TB_FIT_SPAN_MS = 6000;    // minimal rentang untuk estimasi skew
+static constexpr float    TB_SKEW_MAX    = 200e-6f; // kristal normal jauh di bawah ini
+static constexpr uint32_t TB_REANCHOR_MS = 600000;  // re-anchor tiap 10 menit (micros wrap ~71 menit)
+static constexpr uint32_t TB_MAX_GAP_MS  = 10000;   // celah lebih dari ini -> rebase (atau reset bila tidak cocok fit)
+static constexpr int32_t  TB_JUMP_US     = 200000;  // observasi sejauh ini dari fit = waktu GNSS loncat
+static constexpr uint8_t  TB_LOCK_OBS    = 3;
+
+struct Bucket {
+  int32_t t_ms;    // waktu GNSS sejak anchor saat residual minimum
+  int32_t min_us;  // residual minimum: (rx - u0) - dg*1000, tanpa koreksi skew
+};
+
+static TimebaseStats ST;
+static uint32_t period = 86400000u;
+static bool     anchored = false;
+static uint32_t g0 = 0, u0 = 0;   // anchor: waktu GNSS (ms) & micros()
+static uint32_t g_last = 0;
+static uint32_t n_obs = 0;        // observasi sejak anchor
+static Bucket   B[TB_BUCKETS];
+static uint8_t  b_head = 0, b_count = 0;
+static float    skew = 0;         // (micros - GNSS) / GNSS
+static float    offset_us = 0;    // intercept envelope (us)
+
+static inline uint32_t gnss_delta(uint32_t a, uint32_t b){
+  return (b >= a) ? (b - a) : (b + period - a);
+}
+static inline const Bucket& bucket_back(uint8_t i){ // i=0 terbaru
+  return B[(b_head + TB_BUCKETS - 1 - i) % TB_BUCKETS];
+}
+
+static void anchor(uint32_t gnss_ms, uint32_t rx_us){
+  anchored = true;
+  g0 = gnss_ms; u0 = rx_us;
+  b_head = 0; b_count = 0; n_obs = 0;
+  offset_us = 0;
+}
+
+// Pindah origin ke gnss_ms tanpa membuang fit: u0 baru = prediksi fit saat ini, bucket &
+// offset ditranslasi ke origin baru, jadi stamp sebelum/sesudah rebase identik (tidak ada
+// loncatan t_us di tengah run).
+static void rebase(uint32_t gnss_ms){
+  int32_t d_ms  = (int32_t)gnss_delta(g0, gnss_ms);
+  float   pred  = offset_us + skew * (d_ms * 1000.0f);
+  int32_t shift = (int32_t)lroundf(pred);
+  for (Bucket& b : B){ b.t_ms -= d_ms; b.min_us -= shift; }
+  g0 = gnss_ms;
+  u0 += (uint32_t)(d_ms * 1000) + (uint32_t)shift;
+  offset_us = pred - shift;  // sisa pecahan (skew * dg = 0 di origin baru)
+}
+
+void timebase_reset(uint32_t period_ms){
+  period = period_ms;
+  anchored = false;
+  skew = 0;
+  ST = TimebaseStats{};
+}
+
+// Kemiringan envelope (least squares atas minimum per bucket) -> skew
+static void fit(){
+  if (b_count >= 2 && (uint32_t)(bucket_back(0).t_ms - bucket_back(b_count-1).t_ms) >= TB_FIT_SPAN_MS){
+    float mt=0, mu=0;
+    for (uint8_t i=0; i<b_count; ++i){ mt += bucket_back(i).t_ms; mu += bucket_back(i).min_us; }
+    mt /= b_count; mu /= b_count;
+    float sxy=0, sxx=0;
+    for (uint8_t i=0; i<b_count; ++i){
+      float dt = bucket_back(i).t_ms - mt;
+      sxy += dt * (bucket_back(i).min_us - mu);
+      sxx += dt * dt;
+    }
+    if (sxx > 0) skew = constrain((sxy / sxx) * 0.001f, -TB_SKEW_MAX, TB_SKEW_MAX); // us/ms -> us/us
+  }
+  // offset: batas bawah residual setelah koreksi skew
+  uint8_t n = std::min<uint8_t>(b_count, TB_OFFSET_BKTS);
+  float best = 0;
+  for (uint8_t i=0; i<n; ++i){
+    const Bucket& b = bucket_back(i);
+    float r = b.min_us - skew * (b.t_ms * 1000.0f);
+    if (i==0 || r < best) best = r;
+  }
+  offset_us = best;
+}
+
+void timebase_observe(uint32_t gnss_ms, uint32_t rx_us){
+  ST.obs++;
+  if (!anchored){ anchor(gnss_ms, rx_us); }
+  else {
+    uint32_t gap = gnss_delta(g_last, gnss_ms);
+    uint32_t dg  = gnss_delta(g0, gnss_ms);
+    if (gap > TB_MAX_GAP_MS || dg > TB_REANCHOR_MS){
+      // Rebase bila observasi masih cocok dengan fit (re-anchor periodik, GNSS hilang
+      // sebentar); hanya loncatan waktu sungguhan yang membangun envelope dari nol.
+      int32_t late = TB_JUMP_US + 1;
+      if (ST.locked && gap <= TB_REANCHOR_MS){
+        rebase(gnss_ms);
+        late = (int32_t)(rx_us - u0) - (int32_t)lroundf(offset_us);
+      }
+      if (late < -TB_JUMP_US || late > TB_JUMP_US){
+        anchor(gnss_ms, rx_us);  // skew tetap dipakai
+      }
+      ST.resets++;
+    }
+  }
+  g_last = gnss_ms;
+
+  int32_t dg    = (int32_t)gnss_delta(g0, gnss_ms);
+  int32_t resid = (int32_t)(rx_us - u0) - dg * 1000;
+
+  // update minimum bucket aktif / buka bucket baru
+  if (b_count && (uint32_t)bucket_back(0).t_ms / TB_BUCKET_MS == (uint32_t)dg / TB_BUCKET_MS){
+    Bucket& b = B[(b_head + TB_BUCKETS - 1) % TB_BUCKETS];
+    if (resid < b.min_us){ b.min_us = resid; b.t_ms = dg; }
+  } else {
+    B[b_head] = {dg, resid};
+    b_head = (b_head + 1) % TB_BUCKETS;
+    if (b_count < TB_BUCKETS) b_count++;
+  }
+  fit();
+
+  n_obs++;
+  // sekali locked tetap locked sampai timebase_reset(): anchor ulang memakai fit/skew
+  // yang ada, bukan rx_us mentah yang membawa delay UART
+  if (n_obs >= TB_LOCK_OBS) ST.locked = true;
+  ST.skew_ppm = skew * 1e6f;
+  ST.jitter_us = (int32_t)(resid - (offset_us + skew * (dg * 1000.0f)));
+}
+
+bool timebase_to_us(uint32_t gnss_ms, uint32_t fallback_us, uint32_t& out_us){
+  if (!anchored || !ST.locked){ out_us = fallback_us; return false; }
+  // waktu sebelum anchor (jarang) -> delta negatif
+  uint32_t d = gnss_delta(g0, gnss_ms);
+  int32_t dg = (d > period/2) ? (int32_t)(d - period) : (int32_t)d;
+  float corr = offset_us + skew * (dg * 1000.0f);
+  out_us = u0 + (uint32_t)(dg * 1000) + (uint32_t)(int32_t)lroundf(corr);
+  return true;
+}
+
+const TimebaseStats& timebase_stats(){ return ST; }
@@ -0,0 +1,30 @@
+/*
+ * File: timebase.h
+ * Description: Maps GNSS epoch time onto the local micros() clock for precise fix timestamps. Generated by AI for clarity.
+ */
+#pragma once
+/* Timebase GNSS -> micros().
+   Setiap epoch memberi satu observasi: waktu GNSS (ms) + micros() saat kalimatnya
+   diterima. Keterlambatan UART/loop hanya bisa menambah waktu, jadi batas bawah
+   (lower envelope) observasi = waktu pengukuran + latency tetap receiver.
+   Skew kristal ESP32 vs GNSS diestimasi dari kemiringan envelope tsb. */
+#include <Arduino.h>
+
+struct TimebaseStats {
+  uint32_t obs = 0;          // jumlah observasi
+  uint32_t resets = 0;       // re-anchor (rebase periodik / celah / loncatan waktu)
+  int32_t  jitter_us = 0;    // latency observasi terakhir di atas envelope
+  float    skew_ppm = 0;     // estimasi selisih rate micros() vs GNSS
+  bool     locked = false;   // cukup data untuk stamping
+};
+
+// period_ms: periode wrap waktu GNSS (86400000 = UTC time of day, 604800000 = iTOW)
+void timebase_reset(uint32_t period_ms);
+
+// Observasi: waktu GNSS epoch (ms) + micros() saat byte kalimatnya diterima
+void timebase_observe(uint32_t gnss_ms, uint32_t rx_us);
+
+// Waktu GNSS -> domain micros(). false (dan out = fallback_us) jika belum locked
+bool timebase_to_us(uint32_t gnss_ms, uint32_t fallback_us, uint32_t& out_us);
+
+const TimebaseStats& timebase_stats();
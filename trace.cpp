@@ -0,0 +1,162 @@
+/*
+ * File: trace.cpp
+ * Description: Delta/varint encoded run trace with keyframed blocks and in-place 2x decimation when the budget fills. Generated by AI for clarity.
+ */
+#include "trace.h"
+#include <math.h>
+
+// Sampel terkuantisasi (unit integer yang disimpan)
+struct Q { uint32_t t_us; uint32_t d_mm; int32_t v_cms; int32_t lat, lon; };
+struct Key { Q q; uint16_t off; uint8_t n; };  // keyframe absolut + offset data blok
+
+static uint8_t  s_buf[TRACE_BYTES];
+static uint16_t s_used = 0;
+static Key      s_keys[TRACE_MAX_BLOCKS];
+static uint16_t s_nblk = 0;
+static Q        s_last{};          // sampel tersimpan terakhir (basis delta berikutnya)
+static uint32_t s_count = 0;
+static uint16_t s_stride = 1, s_skip = 0;
+static uint8_t  s_decim = 0;
+
+static constexpr size_t REC_MAX = 5 * 5;  // 5 varint x maks 5 byte
+
+// ===== Varint / zigzag =====
+static inline uint32_t zz(int32_t x){ return ((uint32_t)x << 1) ^ (uint32_t)(x >> 31); }
+static inline int32_t  unzz(uint32_t v){ return (int32_t)(v >> 1) ^ -(int32_t)(v & 1); }
+
+static inline uint8_t* put_uv(uint8_t* p, uint32_t v){
+  while (v >= 0x80){ *p++ = (uint8_t)(v | 0x80); v >>= 7; }
+  *p++ = (uint8_t)v;
+  return p;
+}
+static inline const uint8_t* get_uv(const uint8_t* p, uint32_t& v){
+  v = 0;
+  for (uint8_t sh = 0; ; sh += 7){
+    uint8_t b = *p++;
+    v |= (uint32_t)(b & 0x7F) << sh;
+    if (!(b & 0x80) || sh >= 28) return p;
+  }
+}
+
+// Setiap sampel (termasuk keyframe) punya record delta terhadap sampel sebelumnya.
+// Jumlah dua delta tidak pernah butuh byte lebih banyak dari kedua record aslinya,
+// jadi decimate bisa menulis ulang di tempat tanpa menyusul posisi baca.
+static uint8_t* put_rec(uint8_t* p, const Q& prev, const Q& q){
+  p = put_uv(p, zz((int32_t)(q.t_us - prev.t_us)));
+  p = put_uv(p, q.d_mm - prev.d_mm);             // jarak tidak turun
+  p = put_uv(p, zz(q.v_cms - prev.v_cms));
+  p = put_uv(p, zz((int32_t)((uint32_t)q.lat - (uint32_t)prev.lat)));
+  p = put_uv(p, zz((int32_t)((uint32_t)q.lon - (uint32_t)prev.lon)));
+  return p;
+}
+static const uint8_t* get_rec(const uint8_t* p, const Q& prev, Q& q){
+  uint32_t v;
+  p = get_uv(p, v); q.t_us  = prev.t_us + (uint32_t)unzz(v);
+  p = get_uv(p, v); q.d_mm  = prev.d_mm + v;
+  p = get_uv(p, v); q.v_cms = prev.v_cms + unzz(v);
+  p = get_uv(p, v); q.lat   = (int32_t)((uint32_t)prev.lat + (uint32_t)unzz(v));
+  p = get_uv(p, v); q.lon   = (int32_t)((uint32_t)prev.lon + (uint32_t)unzz(v));
+  return p;
+}
+
+static inline const uint8_t* skip_rec(const uint8_t* p){
+  for (uint8_t f = 0; f < 5; ++f) while (*p++ & 0x80) {}
+  return p;
+}
+
+static inline void to_sample(const Q& q, TraceSample& s){
+  s.t_us = q.t_us; s.dist_m = q.d_mm * 0.001f; s.sog_mps = q.v_cms * 0.01f;
+  s.lat_e7 = q.lat; s.lon_e7 = q.lon;
+}
+
+static bool append(const Q& q){
+  bool new_blk = (s_nblk == 0 || s_keys[s_nblk-1].n >= TRACE_BLOCK);
+  if (new_blk && s_nblk >= TRACE_MAX_BLOCKS) return false;
+  if (s_used + REC_MAX > TRACE_BYTES) return false;
+  if (new_blk) s_keys[s_nblk++] = Key{q, s_used, 0};
+  s_used = (uint16_t)(put_rec(s_buf + s_used, s_last, q) - s_buf);
+  s_keys[s_nblk-1].n++;
+  s_last = q;
+  s_count++;
+  return true;
+}
+
+// Padatkan 2x di tempat: per blok decode penuh dulu, lalu tulis ulang sampel genap.
+// Indeks tulis (byte & blok) selalu <= posisi baca, jadi buffer yang sama aman dipakai.
+static void decimate(){
+  static Q tmp[TRACE_BLOCK];
+  const uint16_t nb = s_nblk, used = s_used;
+  s_nblk = 0; s_used = 0; s_count = 0; s_last = Q{};
+  uint32_t gi = 0;
+  for (uint16_t b = 0; b < nb; ++b){
+    const Key k = s_keys[b];
+    const uint16_t end = (b + 1 < nb) ? s_keys[b+1].off : used;
+    const uint8_t* p = s_buf + k.off;
+    Q prev = k.q;
+    p = skip_rec(p);  // record keyframe: nilai absolut sudah ada di Key
+    tmp[0] = k.q;
+    for (uint8_t i = 1; i < k.n && p < s_buf + end; ++i){ p = get_rec(p, prev, tmp[i]); prev = tmp[i]; }
+    for (uint8_t i = 0; i < k.n; ++i) if (!(gi++ & 1)) append(tmp[i]);
+  }
+  if (s_stride < 0x8000) s_stride <<= 1;
+  s_skip = 0;
+  s_decim++;
+}
+
+void trace_reset(){
+  s_used = 0; s_nblk = 0; s_last = Q{}; s_count = 0;
+  s_stride = 1; s_skip = 0; s_decim = 0;
+}
+
+void trace_push(const TraceSample& s){
+  if (s_count && ++s_skip < s_stride) return;
+  s_skip = 0;
+  Q q;
+  q.t_us  = s.t_us;
+  q.d_mm  = (uint32_t)lroundf(max(s.dist_m, 0.0f) * 1000.0f);
+  if (s_count && q.d_mm < s_last.d_mm) q.d_mm = s_last.d_mm;
+  q.v_cms = (int32_t)lroundf(s.sog_mps * 100.0f);
+  q.lat = s.lat_e7; q.lon = s.lon_e7;
+  if (!append(q)){ decimate(); append(q); }
+}
+
+size_t trace_size(){ return s_count; }
+
+bool trace_get(size_t i, TraceSample& out){
+  size_t b = i / TRACE_BLOCK, j = i % TRACE_BLOCK;
+  if (b >= s_nblk || j >= s_keys[b].n) return false;
+  const Key& k = s_keys[b];
+  Q q = k.q;
+  const uint8_t* p = skip_rec(s_buf + k.off);
+  for (size_t n = 0; n < j; ++n){ Q nx; p = get_rec(p, q, nx); q = nx; }
+  to_sample(q, out);
+  return true;
+}
+
+bool trace_find_dist(float dist_m, TraceSample& a, TraceSample& b){
+  if (dist_m <= 0 || s_nblk == 0) return false;
+  const uint32_t xm = (uint32_t)lroundf(dist_m * 1000.0f);
+  // blok terakhir yang keyframe-nya masih di bawah X
+  int lo = 0, hi = (int)s_nblk - 1, blk = -1;
+  while (lo <= hi){
+    int mid = (lo + hi) / 2;
+    if (s_keys[mid].q.d_mm < xm){ blk = mid; lo = mid + 1; } else hi = mid - 1;
+  }
+  if (blk < 0) return false;
+  const Key& k = s_keys[blk];
+  Q prev = k.q;
+  const uint8_t* p = skip_rec(s_buf + k.off);
+  for (uint8_t i = 1; i <= k.n; ++i){
+    Q cur;
+    if (i < k.n) p = get_rec(p, prev, cur);
+    else if (blk + 1 < s_nblk) cur = s_keys[blk+1].q;  // pasangan melintas batas blok
+    else return false;
+    if (cur.d_mm >= xm){ to_sample(prev, a); to_sample(cur, b); return true; }
+    prev = cur;
+  }
+  return false;
+}
+
+TraceStats trace_stats(){
+  return TraceStats{s_count, s_used, s_nblk, s_stride, s_decim};
+}
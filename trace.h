@@ -0,0 +1,41 @@
+/*
+ * File: trace.h
+ * Description: Compressed full-run trace (time, distance, speed, position) in a fixed RAM budget with access by index and distance. Generated by AI for clarity.
+ */
+#pragma once
+/* Jejak run penuh dalam anggaran RAM tetap.
+   Sampel dikuantisasi ke integer (us, mm, cm/s, 1e-7 deg) lalu disimpan sebagai
+   delta varint terhadap sampel sebelumnya; tiap TRACE_BLOCK sampel ada keyframe
+   absolut di indeks blok (akses acak: biner per blok + decode <= TRACE_BLOCK).
+   Bila penuh, jejak di-decimate 2x di tempat (sampel genap dipertahankan) dan
+   stride rekam digandakan: run sepanjang apapun tetap utuh, resolusi yang turun.
+   Bukan thread-safe: panggil dari konteks pemilik race engine. */
+#include <Arduino.h>
+
+// ===== Anggaran RAM =====
+inline constexpr size_t TRACE_BYTES      = 8192; // data delta (~9 B/sampel -> ~45 s @20 Hz sebelum decimate)
+inline constexpr size_t TRACE_BLOCK      = 32;   // sampel per blok (sampel pertama = keyframe)
+inline constexpr size_t TRACE_MAX_BLOCKS = 48;   // indeks keyframe (24 B per blok)
+
+struct TraceSample {
+  uint32_t t_us;     // epoch pengukuran GNSS (micros)
+  float    dist_m;   // jarak path dari start (resolusi 1 mm)
+  float    sog_mps;  // resolusi 1 cm/s
+  int32_t  lat_e7, lon_e7;
+};
+
+struct TraceStats {
+  uint32_t samples;     // sampel tersimpan
+  uint32_t bytes;       // byte data delta terpakai
+  uint16_t blocks;
+  uint16_t stride;      // 1 = setiap sampel direkam, 2 = tiap sampel ke-2, ...
+  uint8_t  decimations; // berapa kali jejak dipadatkan
+};
+
+void   trace_reset();
+void   trace_push(const TraceSample& s);   // sampel dengan dist_m tidak turun
+size_t trace_size();
+bool   trace_get(size_t i, TraceSample& out);
+// Pasangan sampel berurutan a.dist_m < X <= b.dist_m (untuk interpolasi crossing)
+bool   trace_find_dist(float dist_m, TraceSample& a, TraceSample& b);
+TraceStats trace_stats();
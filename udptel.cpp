@@ -0,0 +1,64 @@
+/*
+ * File: udptel.cpp
+ * Description: Builds UdpTelPkt from the latest race snapshot and sends it with WiFiUDP. Generated by AI for clarity.
+ */
+#include "udptel.h"
+#include "udptel_pkt.h"
+#include "global.h"
+#include "logview.h"
+#include "pipeline.h"
+#include <WiFi.h>
+
+static WiFiUDP      s_udp;
+static bool         s_started = false;
+static uint32_t     s_dev = 0;
+static uint32_t     s_last_seq = 0;
+static RaceSnapshot s_snap;
+static UdpTelPkt    s_pkt;
+static UdpTelStats  ST{};
+
+static IPAddress target(){
+  if (UDPTEL_MULTICAST) return IPAddress(UDPTEL_GROUP[0], UDPTEL_GROUP[1], UDPTEL_GROUP[2], UDPTEL_GROUP[3]);
+  return WiFi.broadcastIP();
+}
+
+bool udptel_begin(){
+  if (!UDPTEL_ENABLE || s_started) return s_started;
+  uint8_t mac[6] = {0};
+  WiFi.macAddress(mac);
+  s_dev = ((uint32_t)mac[2] << 24) | ((uint32_t)mac[3] << 16) | ((uint32_t)mac[4] << 8) | mac[5];
+  s_udp.begin(UDPTEL_PORT);  // port lokal = port tujuan, memudahkan filter di sisi pit
+  s_started = true;
+  logf("[UDP] Telemetry -> %s:%u (dev %08lx)", target().toString().c_str(),
+       (unsigned)UDPTEL_PORT, (unsigned long)s_dev);
+  return true;
+}
+
+void udptel_poll(){
+  if (!s_started) return;
+  pipeline_latest(s_snap);
+  if (s_snap.seq == s_last_seq) return;
+  s_last_seq = s_snap.seq;
+  // seq paket = seq snapshot: snapshot yang ditimpa sebelum loop() sempat mengirim
+  // (mis. export panjang menahan job live) juga terlihat sebagai gap di listener
+  ST.seq = s_snap.seq;
+  if (WiFi.status() != WL_CONNECTED){ ST.errors++; return; }
+
+  const RaceSnapshot& S = s_snap;
+  udptel_begin_pkt(s_pkt, s_dev, ST.seq);
+  udptel_set_fix(s_pkt, S.fix);
+  if (S.armed)   s_pkt.flags |= UTF_ARMED;
+  if (S.running) s_pkt.flags |= UTF_RUNNING;
+  s_pkt.dist_mm = (S.cum_dist_m > 0) ? (uint32_t)(S.cum_dist_m * 1000.0f + 0.5f) : 0;
+  for (uint8_t i = 0; i < S.n_results && i < UDPTEL_MAX_TRAPS; ++i){
+    const auto& r = S.results[i];
+    udptel_set_trap(s_pkt, i, r.at_m, r.crossed, r.et_ms, r.trap_kph);
+  }
+  udptel_seal(s_pkt);
+
+  if (!s_udp.beginPacket(target(), UDPTEL_PORT)){ ST.errors++; return; }
+  s_udp.write((const uint8_t*)&s_pkt, sizeof(s_pkt));
+  if (s_udp.endPacket()) ST.sent++; else ST.errors++;
+}
+
+UdpTelStats udptel_stats(){ return ST; }
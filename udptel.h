@@ -0,0 +1,25 @@
+/*
+ * File: udptel.h
+ * Description: Optional UDP broadcast/multicast telemetry sender: one fixed-layout binary packet per race snapshot. Generated by AI for clarity.
+ */
+#pragma once
+/* Telemetri UDP untuk laptop pit yang memantau beberapa mobil sekaligus:
+   - Satu paket UdpTelPkt (udptel_pkt.h, 120 byte) per snapshot race = per fix, dikirim
+     sekali ke broadcast subnet atau grup multicast (UDPTEL_* di global.h). Jumlah
+     listener tidak menambah biaya di ESP32.
+   - Tanpa koneksi/antrian: paket gagal kirim (Wi-Fi putus, buffer lwIP penuh) dibuang
+     dan dihitung. seq paket = seq snapshot pipeline, jadi paket gagal maupun snapshot
+     yang terlewat (ditimpa sebelum sempat dikirim) terlihat sebagai gap di listener.
+   - Dipanggil dari loop() dan membaca snapshot pipeline seperti live.h.
+   Decoder host: host/udp_recv.cpp (racebox_udp_recv). */
+#include <Arduino.h>
+
+struct UdpTelStats {
+  uint32_t sent;      // paket terkirim ke stack IP
+  uint32_t errors;    // beginPacket/endPacket gagal
+  uint32_t seq;       // seq paket terakhir (= seq snapshot)
+};
+
+bool udptel_begin();   // setelah init Wi-Fi; no-op bila UDPTEL_ENABLE=false
+void udptel_poll();    // dari loop(): kirim satu paket per snapshot baru
+UdpTelStats udptel_stats();
@@ -0,0 +1,104 @@
+/*
+ * File: udptel_pkt.h
+ * Description: Fixed-layout binary UDP telemetry packet (fix + race summary + traps) shared by the firmware sender and host decoder. Generated by AI for clarity.
+ */
+#pragma once
+/* Telemetri UDP broadcast/multicast: satu paket 120 byte per snapshot (= per fix).
+   Layout tetap, packed, little-endian; semua trap selalu ada (maks UDPTEL_MAX_TRAPS)
+   jadi paket yang hilang tidak pernah menyembunyikan hasil trap. seq naik 1 per paket
+   (listener bisa hitung loss), device_id membedakan mobil di satu jaringan.
+   Header ini dipakai firmware (udptel.cpp) dan decoder host (host/udp_recv.cpp). */
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include <math.h>
+#include "crc32.h"
+
+inline constexpr uint32_t UDPTEL_MAGIC     = 0x31544252; // "RBT1"
+inline constexpr uint8_t  UDPTEL_VERSION   = 1;
+inline constexpr uint8_t  UDPTEL_MAX_TRAPS = 8;
+
+enum : uint8_t {
+  UTF_VALID   = 1 << 0,
+  UTF_ARMED   = 1 << 1,
+  UTF_RUNNING = 1 << 2,
+};
+
+struct __attribute__((packed)) UdpTelTrap {
+  uint32_t et_us;     // ET (us) bila crossed
+  uint16_t kph_c;     // trap speed * 100 (0 = belum ada)
+  uint16_t at_dm;     // posisi trap (desimeter)
+};
+
+struct __attribute__((packed)) UdpTelPkt {
+  uint32_t magic;
+  uint8_t  version;
+  uint8_t  flags;         // UTF_*
+  uint8_t  n_traps;
+  uint8_t  crossed_mask;  // bit i = trap i crossed
+  uint32_t device_id;
+  uint32_t seq;
+  uint32_t gnss_ms;       // waktu GNSS fix (ms dari tengah malam / iTOW)
+  uint32_t t_us;          // epoch pengukuran (micros pengirim)
+  int32_t  lat_e7, lon_e7;
+  int32_t  alt_cm;
+  uint16_t sog_cms;
+  uint16_t cog_cdeg;
+  uint16_t hacc_cm;       // 0xFFFF = tidak ada
+  uint8_t  hdop_d;        // HDOP * 10
+  uint8_t  fixQ;
+  uint8_t  sv;
+  uint8_t  rsv[3];
+  uint32_t dist_mm;       // jarak race dari start
+  UdpTelTrap trap[UDPTEL_MAX_TRAPS];
+  uint32_t crc32;         // CRC-32 IEEE semua byte sebelum field ini
+};
+static_assert(sizeof(UdpTelPkt) == 120, "UdpTelPkt harus 120 byte");
+
+static inline uint32_t udptel_clamp_u(float v, float scale, uint32_t maxv){
+  if (!(v > 0)) return 0;
+  float x = v * scale + 0.5f;
+  return (x >= (float)maxv) ? maxv : (uint32_t)x;
+}
+
+// Isi bagian fix; field lain diisi pemanggil
+template <typename Fix>
+inline void udptel_set_fix(UdpTelPkt& p, const Fix& f){
+  p.gnss_ms = f.gnss_ms; p.t_us = f.t_us;
+  p.lat_e7 = f.lat_e7; p.lon_e7 = f.lon_e7;
+  p.alt_cm  = (int32_t)lroundf(f.alt_m * 100.0f);
+  p.sog_cms = (uint16_t)udptel_clamp_u(f.sog_mps, 100.0f, 65535);
+  p.cog_cdeg= (uint16_t)udptel_clamp_u(f.cog_deg, 100.0f, 35999);
+  p.hacc_cm = (f.hacc_m < 0) ? 0xFFFF : (uint16_t)udptel_clamp_u(f.hacc_m, 100.0f, 65534);
+  p.hdop_d  = (uint8_t)udptel_clamp_u(f.hdop, 10.0f, 255);
+  p.fixQ = f.fixQ; p.sv = f.sv;
+  if (f.valid) p.flags |= UTF_VALID;
+}
+
+inline void udptel_set_trap(UdpTelPkt& p, uint8_t i, float at_m, bool crossed, float et_ms, float trap_kph){
+  if (i >= UDPTEL_MAX_TRAPS) return;
+  UdpTelTrap& t = p.trap[i];
+  t.et_us = crossed ? udptel_clamp_u(et_ms, 1000.0f, 0xFFFFFFFFu) : 0;
+  t.kph_c = (uint16_t)udptel_clamp_u(trap_kph, 100.0f, 65535);
+  t.at_dm = (uint16_t)udptel_clamp_u(at_m, 10.0f, 65535);
+  if (crossed) p.crossed_mask |= (uint8_t)(1u << i);
+  if (i + 1 > p.n_traps) p.n_traps = i + 1;
+}
+
+inline void udptel_begin_pkt(UdpTelPkt& p, uint32_t device_id, uint32_t seq){
+  memset(&p, 0, sizeof(p));
+  p.magic = UDPTEL_MAGIC; p.version = UDPTEL_VERSION;
+  p.device_id = device_id; p.seq = seq;
+}
+
+inline void udptel_seal(UdpTelPkt& p){
+  p.crc32 = crc32_ieee((const uint8_t*)&p, offsetof(UdpTelPkt, crc32));
+}
+
+// Validasi paket diterima (ukuran, magic, versi, CRC)
+inline bool udptel_check(const void* buf, size_t n, UdpTelPkt& out){
+  if (n != sizeof(UdpTelPkt)) return false;
+  memcpy(&out, buf, sizeof(out));
+  return out.magic == UDPTEL_MAGIC && out.version == UDPTEL_VERSION &&
+         out.crc32 == crc32_ieee((const uint8_t*)&out, offsetof(UdpTelPkt, crc32));
+}